@@ -35,9 +35,14 @@
       ],
       "sources": [
         "src/node_binding.cpp",
+        "src/sync_binding.cpp",
         "src/core/camera_manager.cpp",
         "src/core/control_manager.cpp",
+        "src/core/control_table.cpp",
         "src/core/stream_manager.cpp",
+        "src/core/shared_camera_manager.cpp",
+        "src/core/frame_synchronizer.cpp",
+        "src/core/frame_ring.cpp",
         "src/encoders/jpeg_encoder.cpp"
       ],
       "include_dirs": [
@@ -0,0 +1,73 @@
+// bench-controls.ts - Cost of filling a request's control list
+//
+// Sets N controls, then changes one of them with every frame, the pattern
+// of an exposure or focus loop. Runs once writing only the changed controls
+// (the default) and once writing all N into every request, and reports the
+// ControlList population time per request the camera measured for each.
+//
+//   npx tsx src/bench-controls.ts [seconds] [controls]
+
+import { builder } from '@nodify_at/picamera.js'
+import type { Controls } from '@nodify_at/picamera.js'
+
+const seconds = Number(process.argv[2] ?? 10)
+const count = Number(process.argv[3] ?? 7)
+
+// Held at fixed values, brightness is the one that keeps changing
+const fixed: Controls[] = [
+    { contrast: 1.0 },
+    { saturation: 1.0 },
+    { sharpness: 1.0 },
+    { analogueGain: 2.0 },
+    { exposureTime: 10000 },
+    { colourGains: [1.5, 1.5] },
+]
+const controls: Controls = Object.assign({ brightness: 0 }, ...fixed.slice(0, Math.max(0, count - 1)))
+const controlCount = Object.keys(controls).length
+
+const cameraBuilder = builder().rgb(320, 240).fps(30).controls(controls)
+const camera = cameraBuilder.build()
+
+let step = 0
+camera.on('rgb', () => {
+    // One changed control per frame, picked up by the next requeued request
+    step++
+    camera.setControls({ brightness: (step % 2) * 0.1 })
+})
+
+interface Sample {
+    applies: number
+    written: number
+    totalNs: number
+}
+
+const sample = (): Sample => {
+    const stats = camera.getStats()
+    return {
+        applies: stats.controlApplies,
+        written: stats.controlsWritten,
+        totalNs: stats.controlApplyAvgUs * 1000 * stats.controlApplies,
+    }
+}
+
+async function run(writeAll: boolean): Promise<void> {
+    camera.reconfigure({ ...cameraBuilder.toConfig(), writeAllControls: writeAll })
+    camera.start()
+
+    // Skip start-up, whose first request always carries every control
+    await new Promise(resolve => setTimeout(resolve, 1000))
+    const before = sample()
+    await new Promise(resolve => setTimeout(resolve, seconds * 1000))
+    const after = sample()
+    camera.stop()
+
+    const applies = after.applies - before.applies
+    const nsPerRequest = applies ? (after.totalNs - before.totalNs) / applies : 0
+    const writtenPerRequest = applies ? (after.written - before.written) / applies : 0
+    console.log(`${writeAll ? 'all controls:    ' : 'changed controls:'} ${nsPerRequest.toFixed(0)} ns/request, `
+        + `${writtenPerRequest.toFixed(1)} controls written/request over ${applies} requests`)
+}
+
+console.log(`${controlCount} controls set, one changing per frame`)
+await run(false)
+await run(true)
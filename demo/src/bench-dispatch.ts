@@ -0,0 +1,64 @@
+// bench-dispatch.ts - Per-frame cost of handing frames to JavaScript
+//
+// Runs a small RGB stream as fast as the sensor allows with a no-op listener
+// and reports delivered frame rate, capture-to-callback latency and event
+// loop time per frame, all measured in the listener. Run it once against the
+// previous release and once against this build to compare; builds with
+// getStats() also report drops and the native share of dispatch.
+//
+//   npx tsx src/bench-dispatch.ts [seconds] [batchFrames]
+
+import { performance } from 'node:perf_hooks'
+import { builder } from '@nodify_at/picamera.js'
+
+const seconds = Number(process.argv[2] ?? 10)
+const batchFrames = Number(process.argv[3] ?? 0)
+
+// Only builder calls the previous release has, except batch()
+const cameraBuilder = builder().rgb(320, 240).fps(120)
+if (batchFrames > 0) cameraBuilder.batch(batchFrames)
+const camera = cameraBuilder.build()
+
+// Sensor timestamps come from the kernel's monotonic clock, like hrtime,
+// as long as the system does not suspend
+let measuring = false
+let frames = 0
+const latenciesUs: number[] = []
+camera.on('rgb', (frame: { timestamp: bigint }) => {
+    if (!measuring) return
+    frames++
+    latenciesUs.push(Number(process.hrtime.bigint() - frame.timestamp) / 1000)
+})
+
+camera.start()
+
+// Skip start-up, then measure a steady state
+await new Promise(resolve => setTimeout(resolve, 1000))
+measuring = true
+const startElu = performance.eventLoopUtilization()
+const startTime = performance.now()
+
+await new Promise(resolve => setTimeout(resolve, seconds * 1000))
+
+measuring = false
+const elu = performance.eventLoopUtilization(startElu)
+const elapsedMs = performance.now() - startTime
+
+// The previous release has no getStats()
+const native = camera as unknown as { getStats?: () => { framesDropped?: number; dispatchAvgNs?: number } }
+const stats = typeof native.getStats === 'function' ? native.getStats() : {}
+camera.stop()
+
+latenciesUs.sort((a, b) => a - b)
+const percentile = (p: number) => latenciesUs[Math.min(latenciesUs.length - 1, Math.floor(latenciesUs.length * p))] ?? 0
+const meanUs = latenciesUs.reduce((sum, value) => sum + value, 0) / (latenciesUs.length || 1)
+
+const nsPerFrame = frames ? (elu.active * 1e6) / frames : 0
+console.log(`frames:             ${frames} in ${(elapsedMs / 1000).toFixed(1)} s (${(frames * 1000 / elapsedMs).toFixed(1)} fps)`)
+console.log(`latency:            ${meanUs.toFixed(0)} us mean, ${percentile(0.5).toFixed(0)} us p50, ${percentile(0.99).toFixed(0)} us p99`)
+if (stats.framesDropped !== undefined) console.log(`dropped:            ${stats.framesDropped}`)
+console.log(`event loop:         ${(elu.utilization * 100).toFixed(1)} % busy`)
+console.log(`event loop / frame: ${nsPerFrame.toFixed(0)} ns`)
+if (stats.dispatchAvgNs !== undefined) {
+    console.log(`native dispatch:    ${stats.dispatchAvgNs.toFixed(0)} ns/frame`)
+}
@@ -0,0 +1,49 @@
+// check-sync.ts - Pairing must not stall when the event loop falls behind
+//
+// Feeds two synthetic sources with jittered timestamps, pushing many more
+// pairs in one synchronous burst than the native pair queue holds. Pushes
+// happen on the JS thread, so any wait for that queue would hang here.
+//
+//   npx tsx src/check-sync.ts [pairs]
+
+import { createFrameSynchronizer } from '@nodify_at/picamera.js'
+
+const pushes = Number(process.argv[2] ?? 64)
+const periodNs = 33_333_333n
+const jitterNs = 2_000_000
+
+const sync = createFrameSynchronizer({ toleranceUs: 5000 })
+let delivered = 0
+sync.on('pair', () => {
+    delivered++
+})
+
+const frame = Buffer.alloc(64)
+const jitter = () => BigInt(Math.round((Math.random() * 2 - 1) * jitterNs))
+
+const startTime = performance.now()
+for (let i = 0; i < pushes; i++) {
+    const base = BigInt(i) * periodNs
+    sync.push(0, frame, base + jitter(), i)
+    sync.push(1, frame, base + jitter(), i)
+}
+const pushMs = performance.now() - startTime
+
+// Let queued pairs reach the listener
+await new Promise(resolve => setTimeout(resolve, 100))
+
+const stats = sync.getStats()
+sync.close()
+
+console.log(`pushed:   ${pushes} pairs in ${pushMs.toFixed(1)} ms`)
+console.log(`paired:   ${stats.pairs}, delivered ${delivered}, dropped ${stats.pairsDropped}`)
+
+if (delivered + stats.pairsDropped !== stats.pairs) {
+    console.error('FAIL: delivered and dropped pairs do not add up to pairs')
+    process.exit(1)
+}
+if (stats.pairs > 4 && stats.pairsDropped === 0) {
+    console.error('FAIL: burst larger than the pair queue dropped nothing')
+    process.exit(1)
+}
+console.log('OK')
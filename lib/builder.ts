@@ -1,4 +1,4 @@
-import type { AfMode, AwbMode, CameraConfig, Controls, ExposureMode, NativeAddon } from './types.js'
+import type { AfMode, AwbMode, CameraConfig, CameraSelector, Controls, ExposureMode, NativeAddon, OverflowPolicy } from './types.js'
 import { CameraError, ErrorCodes, validateDimensions, validateRange } from './types.js'
 import { Camera } from './camera.js'
 
@@ -17,6 +17,30 @@ export class CameraBuilder {
 
     constructor(private readonly addon: NativeAddon) {}
 
+    /**
+     * Select the camera by libcamera id, or by model and/or location. A
+     * selector object calls listCameras(), with its cost; pass an id from
+     * an earlier listCameras() to avoid it.
+     */
+    camera(selector: string | CameraSelector): this {
+        if (typeof selector === 'string') {
+            this.config.cameraId = selector
+            return this
+        }
+
+        const match = this.addon.listCameras().find(
+            (info) =>
+                (selector.id === undefined || info.id === selector.id) &&
+                (selector.model === undefined || info.model === selector.model) &&
+                (selector.location === undefined || info.location === selector.location),
+        )
+        if (!match) {
+            throw new CameraError(`No camera matches ${JSON.stringify(selector)}`, ErrorCodes.CAMERA_NOT_FOUND)
+        }
+        this.config.cameraId = match.id
+        return this
+    }
+
     /**
      * Configure RAW stream dimensions
      */
@@ -35,11 +59,16 @@ export class CameraBuilder {
     }
 
     /**
-     * Add JPEG stream
+     * Add JPEG stream, optionally with its own quality
      */
-    jpeg(width = 1920, height = 1080): this {
+    jpeg(width = 1920, height = 1080, quality?: number): this {
         validateDimensions(width, height)
-        this.config.streams.push({ type: 'jpeg', width, height })
+        if (quality === undefined) {
+            this.config.streams.push({ type: 'jpeg', width, height })
+        } else {
+            validateRange(quality, 1, 100, 'JPEG quality')
+            this.config.streams.push({ type: 'jpeg', width, height, quality })
+        }
         return this
     }
 
@@ -52,6 +81,19 @@ export class CameraBuilder {
         return this
     }
 
+    /**
+     * Keep the most recent full resolution frames for zero-shutter-lag
+     * captureStill() while the other streams keep running
+     */
+    zsl(width = 4608, height = 2592, depth = 3, quality = 95): this {
+        validateDimensions(width, height)
+        validateRange(depth, 1, 8, 'ZSL depth')
+        validateRange(quality, 1, 100, 'Still quality')
+        this.config.streams.push({ type: 'still', width, height, quality })
+        this.config.zslDepth = depth
+        return this
+    }
+
     /**
      * Set JPEG encoder queue size
      */
@@ -61,6 +103,94 @@ export class CameraBuilder {
         return this
     }
 
+    /**
+     * Deliver each stream's frame as soon as its buffer completes instead of
+     * waiting for the whole request (lower latency for fast streams)
+     */
+    earlyDelivery(enabled = true): this {
+        this.config.earlyDelivery = enabled
+        return this
+    }
+
+    /**
+     * Write every set control into each request that carries control
+     * changes, instead of only the changed ones. Only useful to measure
+     * what writing changes alone saves, see demo/src/bench-controls.ts.
+     */
+    writeAllControls(enabled = true): this {
+        this.config.writeAllControls = enabled
+        return this
+    }
+
+    /**
+     * Emit one 'group' event per request carrying the JPEG and RGB outputs of
+     * all streams instead of separate per-stream events
+     * @param deadlineMs Emit the group without JPEGs that are still encoding after this long
+     */
+    groupedDelivery(deadlineMs = 100): this {
+        validateRange(deadlineMs, 1, 10000, 'Group deadline')
+        this.config.groupedDelivery = true
+        this.config.groupDeadlineMs = deadlineMs
+        return this
+    }
+
+    /**
+     * Copy each JPEG and still frame into a Buffer of its own that
+     * postMessage() can transfer to a worker without another copy. Costs
+     * one copy of the encoded frame per frame, on the event loop. RGB
+     * frames are not copied; share them through createFrameRing().
+     */
+    transferable(enabled = true): this {
+        this.config.transferable = enabled
+        return this
+    }
+
+    /**
+     * Take frames with camera.nextFrame() or camera.frames() instead of
+     * events. Only the latest frame per stream is kept, and JPEG frames are
+     * only encoded while a request is pending.
+     */
+    pull(enabled = true): this {
+        this.config.pull = enabled
+        return this
+    }
+
+    /**
+     * Limit the frames per stream waiting for a busy event loop. Capture
+     * never waits for JavaScript; frames over the limit are dropped and
+     * counted in getStats().framesDropped. JPEG encoders that fall behind
+     * drop frames the same way, counted in jpegFramesDropped.
+     */
+    delivery(queueSize = 4, overflow: OverflowPolicy = 'dropOldest'): this {
+        validateRange(queueSize, 1, 256, 'Delivery queue size')
+        this.config.delivery = { queueSize, overflow }
+        return this
+    }
+
+    /**
+     * Deliver up to maxFrames frames of a stream with one native call,
+     * waiting at most maxDelayMs for a batch to fill. Cuts per-frame N-API
+     * overhead at high frame rates.
+     */
+    batch(maxFrames = 8, maxDelayMs = 10): this {
+        validateRange(maxFrames, 1, 256, 'Batch size')
+        validateRange(maxDelayMs, 1, 1000, 'Batch delay')
+        this.config.batch = { maxFrames, maxDelayMs }
+        return this
+    }
+
+    /**
+     * Report a STALLED error when no frame completes or a JPEG frame waits in
+     * its encoder for longer than the threshold, and optionally restart the
+     * pipeline automatically
+     */
+    watchdog(stallTimeoutMs = 2000, autoRecover = true): this {
+        validateRange(stallTimeoutMs, 100, 60000, 'Stall timeout')
+        this.config.stallTimeoutMs = stallTimeoutMs
+        this.config.autoRecover = autoRecover
+        return this
+    }
+
     /**
      * Set target frame rate
      */
@@ -69,11 +199,50 @@ export class CameraBuilder {
         this.ensureControls()
         const controls = this.config.controls
         if (controls) {
+            delete controls.minFps
+            delete controls.maxFps
+            delete controls.maxThroughput
             controls.targetFps = fps
         }
         return this
     }
 
+    /**
+     * Let the frame rate vary within a range, so auto exposure can lengthen
+     * frames in low light instead of raising the gain
+     */
+    fpsRange(minFps: number, maxFps: number): this {
+        validateRange(minFps, 0.01, 120, 'Minimum FPS')
+        validateRange(maxFps, minFps, 120, 'Maximum FPS')
+        this.ensureControls()
+        const controls = this.config.controls
+        if (controls) {
+            delete controls.targetFps
+            controls.minFps = minFps
+            controls.maxFps = maxFps
+            controls.maxThroughput = false
+        }
+        return this
+    }
+
+    /**
+     * Run at the shortest frame duration the sensor mode supports, optionally
+     * letting auto exposure slow down to minFps in low light
+     */
+    maxThroughput(minFps?: number): this {
+        if (minFps !== undefined) validateRange(minFps, 0.01, 120, 'Minimum FPS')
+        this.ensureControls()
+        const controls = this.config.controls
+        if (controls) {
+            delete controls.targetFps
+            delete controls.minFps
+            delete controls.maxFps
+            if (minFps !== undefined) controls.minFps = minFps
+            controls.maxThroughput = true
+        }
+        return this
+    }
+
     /**
      * Set JPEG quality
      */
@@ -187,6 +356,16 @@ export class CameraBuilder {
         return this
     }
 
+    /**
+     * Get the configuration built so far, e.g. for Camera.reconfigure()
+     */
+    toConfig(): CameraConfig {
+        if (this.config.streams.length === 0) {
+            throw new CameraError('At least one stream must be configured', ErrorCodes.NO_STREAMS)
+        }
+        return structuredClone(this.config)
+    }
+
     /**
      * Build camera instance
      */
@@ -197,6 +376,20 @@ export class CameraBuilder {
         return new Camera(this.addon, this.config)
     }
 
+    /**
+     * Build a camera whose libcamera start-up, acquisition and stream
+     * configuration run on a worker thread instead of the event loop
+     */
+    async buildAsync(): Promise<Camera> {
+        if (this.config.streams.length === 0) {
+            throw new CameraError('At least one stream must be configured', ErrorCodes.NO_STREAMS)
+        }
+
+        const camera = new Camera(this.addon, this.config, true)
+        await camera.initialize()
+        return camera
+    }
+
     /**
      * Build and start camera
      */
@@ -6,20 +6,43 @@ import type {
     Controls,
     CameraEvent,
     FrameEvent,
+    FrameGroupEvent,
+    FrameBatchEvent,
     CameraCapabilities,
     Camera as NativeCamera,
     NativeAddon,
     FrameData,
     SensorInfo,
+    CameraStats,
+    CropRegion,
+    NativeChannel,
+    LifecycleTimings,
 } from './types.js'
-import { CameraError, isFrameEvent, isErrorEvent, ErrorCodes } from './types.js'
+import {
+    CameraError,
+    isFrameEvent,
+    isErrorEvent,
+    isFrameGroupEvent,
+    isFrameBatchEvent,
+    ErrorCodes,
+    FRAME_METADATA_FIELDS,
+    NATIVE_STREAM_TYPES,
+} from './types.js'
+import { FrameRing } from './ring.js'
 
 // Properly typed EventEmitter interface
 export interface CameraEvents {
     jpeg: [frame: FrameData]
     rgb: [frame: FrameData]
+    still: [frame: FrameData]
     error: [error: CameraError]
     frame: [event: FrameEvent]
+    group: [group: FrameGroupEvent]
+    batch: [batch: FrameBatchEvent]
+    ring: [ring: FrameRing, slot: number]
+    // Emitted by EventEmitter itself
+    newListener: [event: string | symbol, listener: (...args: unknown[]) => void]
+    removeListener: [event: string | symbol, listener: (...args: unknown[]) => void]
 }
 
 export declare interface Camera {
@@ -35,35 +58,118 @@ export declare interface Camera {
 export class Camera extends EventEmitter {
     private nativeCamera: NativeCamera
     private isRunning = false
+    private rings = new Map<number, FrameRing>()
 
-    constructor(addon: NativeAddon, config: CameraConfig) {
+    /**
+     * @param deferInitialize Leave acquiring and configuring the camera to
+     *        initialize(), off the event loop
+     */
+    constructor(addon: NativeAddon, config: CameraConfig, deferInitialize = false) {
         super()
-        this.nativeCamera = new addon.Camera(config)
+        this.nativeCamera = new addon.Camera(config, deferInitialize)
         this.setupEventHandler()
     }
 
+    /**
+     * Start the libcamera manager, acquire and configure the camera on a
+     * worker thread. Only for cameras constructed with deferInitialize.
+     */
+    initialize(): Promise<LifecycleTimings> {
+        return this.nativeCamera.initialize()
+    }
+
+    /**
+     * Errors always have a handler; stream channels are only subscribed
+     * while their events have listeners, so unused streams skip all N-API
+     * work. 'frame' and 'batch' listeners take every stream without a
+     * listener of its own.
+     */
     private setupEventHandler(): void {
-        this.nativeCamera.on('frame', (event: CameraEvent) => {
-            if (isErrorEvent(event)) {
-                this.emit('error', new CameraError(event.error))
+        // Single frames come as positional arguments and are wrapped here,
+        // so every frame event has the same shape
+        const handler = (
+            event: CameraEvent | number,
+            data?: Buffer,
+            timestamp?: bigint,
+            sequence?: number,
+            streamId?: number,
+            metadata?: Float64Array,
+        ) => {
+            if (typeof event !== 'number') {
+                this.dispatch(event)
                 return
             }
 
-            if (isFrameEvent(event)) {
-                // Emit specific stream events
-                switch (event.stream) {
-                    case 'jpeg':
-                        this.emit('jpeg', event.frame)
-                        break
-                    case 'rgb':
-                        this.emit('rgb', event.frame)
-                        break
+            const frame: FrameData = { data: data!, timestamp: timestamp!, sequence: sequence!, streamId: streamId!, metadata: metadata! }
+            this.dispatch({ type: 'frame', stream: NATIVE_STREAM_TYPES[event]!, frame })
+        }
+        const channelOf = (name: string | symbol): NativeChannel | undefined => {
+            if (name === 'jpeg' || name === 'rgb' || name === 'still' || name === 'group') return name
+            if (name === 'frame' || name === 'batch') return 'frame'
+            return undefined
+        }
+        const listeners = (channel: NativeChannel) =>
+            channel === 'frame' ? this.listenerCount('frame') + this.listenerCount('batch') : this.listenerCount(channel)
+
+        this.nativeCamera.on('error', handler)
+
+        this.on('newListener', (name: string | symbol) => {
+            const channel = channelOf(name)
+            if (channel && listeners(channel) === 0) this.nativeCamera.on(channel, handler)
+        })
+        this.on('removeListener', (name: string | symbol) => {
+            const channel = channelOf(name)
+            if (channel && listeners(channel) === 0) this.nativeCamera.off(channel)
+        })
+    }
+
+    private dispatch(event: CameraEvent): void {
+        if (isErrorEvent(event)) {
+            this.emit('error', new CameraError(event.error, event.code, event.stalledMs, event.recovering, event.streamId))
+            return
+        }
+
+        if (isFrameGroupEvent(event)) {
+            this.emit('group', event)
+            return
+        }
+
+        if (isFrameBatchEvent(event)) {
+            this.emit('batch', event)
+            if (this.listenerCount(event.stream) === 0 && this.listenerCount('frame') === 0) return
+
+            // Per-frame listeners get plain objects built in JavaScript,
+            // still far cheaper than one native call per frame
+            for (let i = 0; i < event.data.length; i++) {
+                const frame: FrameData = {
+                    data: event.data[i]!,
+                    timestamp: event.timestamps[i]!,
+                    sequence: event.sequences[i]!,
+                    streamId: event.streamId,
+                    metadata: event.metadata.subarray(i * FRAME_METADATA_FIELDS, (i + 1) * FRAME_METADATA_FIELDS),
                 }
+                this.dispatch({ type: 'frame', stream: event.stream, frame })
+            }
+            return
+        }
 
-                // Also emit a general frame event
-                this.emit('frame', event)
+        if (isFrameEvent(event)) {
+            // Emit specific stream events
+            switch (event.stream) {
+                case 'jpeg':
+                    this.emit('jpeg', event.frame)
+                    break
+                case 'rgb':
+                    this.emit('rgb', event.frame)
+                    break
+                case 'still':
+                    this.emit('still', event.frame)
+                    break
             }
-        })
+
+            // Also emit a general frame event
+            this.emit('frame', event)
+        }
     }
 
     /**
@@ -82,16 +188,126 @@ export class Camera extends EventEmitter {
     }
 
     /**
-     * Stop camera streaming
+     * Resolve with the next frame of a stream configured with pull: true.
+     * The latest frame is returned right away if nobody took it yet; on
+     * JPEG streams a frame is encoded for the request. stop() rejects calls
+     * still pending.
+     * @param streamId Index of the stream in CameraConfig.streams
+     */
+    nextFrame(streamId = 0): Promise<FrameData> {
+        return this.nativeCamera.nextFrame(streamId)
+    }
+
+    /**
+     * Iterate over the frames of a pull-mode stream while the camera runs.
+     * Frames arriving while the loop body runs replace each other, so a
+     * slow consumer always gets the most recent one.
+     */
+    async *frames(streamId = 0): AsyncGenerator<FrameData> {
+        while (this.isRunning) {
+            let frame: FrameData
+            try {
+                frame = await this.nextFrame(streamId)
+            } catch (error) {
+                // stop() rejects the pending call and ends the loop.
+                // stopAsync() rejects it before its own Promise settles.
+                if (!this.isRunning || !this.nativeCamera.isRunning()) return
+                throw error
+            }
+            yield frame
+        }
+    }
+
+    /**
+     * Start streaming without blocking the event loop: buffers are mapped
+     * and the camera started on a worker thread. Resolves once the first
+     * frame arrived or firstFrameTimeoutMs passed, 0 to not wait for it.
+     */
+    async startAsync(firstFrameTimeoutMs = 2000): Promise<LifecycleTimings> {
+        if (this.isRunning) {
+            throw new CameraError('Camera is already running', ErrorCodes.ALREADY_RUNNING)
+        }
+
+        try {
+            const timings = await this.nativeCamera.startAsync(firstFrameTimeoutMs)
+            this.isRunning = true
+            return timings
+        } catch (error) {
+            throw new CameraError((error as Error).message, ErrorCodes.START_FAILED)
+        }
+    }
+
+    /**
+     * Stop streaming on a worker thread, e.g. while encoders finish
+     */
+    async stopAsync(): Promise<LifecycleTimings> {
+        try {
+            return await this.nativeCamera.stopAsync()
+        } finally {
+            this.isRunning = this.nativeCamera.isRunning()
+        }
+    }
+
+    /**
+     * reconfigure() on a worker thread. Resolves once the first frame of the
+     * new configuration arrived if streaming was running.
+     */
+    async reconfigureAsync(config: CameraConfig, firstFrameTimeoutMs = 2000): Promise<LifecycleTimings> {
+        try {
+            return await this.nativeCamera.reconfigureAsync(config, firstFrameTimeoutMs)
+        } finally {
+            // A failed reconfigure can leave streaming stopped
+            this.isRunning = this.nativeCamera.isRunning()
+        }
+    }
+
+    /**
+     * Stop camera streaming. The camera stays acquired, so start() can be
+     * called again without re-creating it.
      */
     stop(): void {
         if (this.isRunning) {
             this.nativeCamera.stop()
             this.isRunning = false
-            this.removeAllListeners()
         }
     }
 
+    /**
+     * Encode a full resolution JPEG from the zero-shutter-lag ring without
+     * interrupting the other streams. The result is emitted as 'still'.
+     * @param at Sensor timestamp to match, defaults to the most recent frame
+     */
+    captureStill(at?: bigint): boolean {
+        return at === undefined ? this.nativeCamera.captureStill() : this.nativeCamera.captureStill(at)
+    }
+
+    /**
+     * Stop capturing frames while keeping buffers allocated and the camera
+     * started, so resume() delivers a frame within about one frame interval
+     */
+    pause(): boolean {
+        return this.nativeCamera.pause()
+    }
+
+    /**
+     * Resume capturing after pause(); time to the first frame is reported
+     * as lastResumeMs in getStats()
+     */
+    resume(): boolean {
+        return this.nativeCamera.resume()
+    }
+
+    /**
+     * Apply a new stream configuration without releasing the camera.
+     * Streaming restarts automatically if it was running; the blackout is
+     * reported as lastBlackoutMs in getStats().
+     */
+    reconfigure(config: CameraConfig): boolean {
+        const ok = this.nativeCamera.reconfigure(config)
+        this.isRunning = this.nativeCamera.isRunning()
+        return ok
+    }
+
     /**
      * Apply new control values
      */
@@ -99,6 +315,93 @@ export class Camera extends EventEmitter {
         return this.nativeCamera.setControls(controls)
     }
 
+    /**
+     * Attach controls to one specific future request instead of whichever
+     * completes next. The frame carrying them reports the returned tag in
+     * metadata[FrameMetadataIndex.CONTROL_TAG].
+     * @param framesAhead Requests to skip first, 0 for the next one queued
+     */
+    scheduleControls(controls: Controls, framesAhead = 0): number {
+        return this.nativeCamera.scheduleControls(controls, framesAhead)
+    }
+
+    /**
+     * Cycle through control sets on consecutive frames, e.g. exposures for
+     * HDR brackets. Pass an empty list to stop; the last set stays in effect.
+     * @returns Tag of each set, reported in metadata[FrameMetadataIndex.CONTROL_TAG]
+     */
+    bracket(sets: Controls[]): number[] {
+        return this.nativeCamera.bracket(sets)
+    }
+
+    /**
+     * Zoom and pan in the ISP: every stream is scaled from the cropped
+     * sensor area, so encoders only see the zoomed pixels. The crop eases
+     * towards the region over transitionFrames requests; each frame reports
+     * the crop it was captured with in metadata[FrameMetadataIndex.CROP_X]
+     * to CROP_HEIGHT.
+     * @returns false if the camera has no ScalerCrop or the region does not
+     *          fit within { x: 0, y: 0, width: 1, height: 1 }
+     */
+    setCrop(region: CropRegion, transitionFrames = 0): boolean {
+        return this.nativeCamera.setCrop(region, transitionFrames)
+    }
+
+    /**
+     * Zoom by a factor around a point of the full field of view, keeping
+     * its aspect ratio. The window is shifted inwards near the edges.
+     * @param factor 1 for the full field of view, 2 for half its width
+     */
+    zoom(factor: number, options: { centerX?: number; centerY?: number; transitionFrames?: number } = {}): boolean {
+        const { centerX = 0.5, centerY = 0.5, transitionFrames = 0 } = options
+        if (!(factor >= 1)) {
+            throw new CameraError(`Zoom factor out of range: ${factor} (must be at least 1)`, ErrorCodes.OUT_OF_RANGE)
+        }
+
+        const size = 1 / factor
+        const clamp = (center: number) => Math.min(Math.max(center - size / 2, 0), 1 - size)
+        return this.setCrop({ x: clamp(centerX), y: clamp(centerY), width: size, height: size }, transitionFrames)
+    }
+
+    /**
+     * Copy every frame of an RGB stream into a ring of slots in a new
+     * SharedArrayBuffer, for workers to read without per-frame allocations.
+     * Workers block on ring.wait(); the main thread gets 'ring' events,
+     * coalesced while the previous one is being handled.
+     * @param streamId Index of an RGB stream in CameraConfig.streams
+     * @param slots Frames kept; readers lagging by more see overwritten slots
+     */
+    createFrameRing(streamId: number, slots = 4): FrameRing {
+        const layout = this.nativeCamera.frameLayout(streamId)
+        if (!layout || layout.stream !== 'rgb') {
+            throw new CameraError(`Stream ${streamId} is not an RGB stream`, ErrorCodes.NO_STREAMS)
+        }
+        if (!Number.isInteger(slots) || slots < 1) {
+            throw new CameraError(`Ring slots out of range: ${slots} (must be at least 1)`, ErrorCodes.OUT_OF_RANGE)
+        }
+
+        const buffer = new SharedArrayBuffer(FrameRing.bytes(slots, layout.frameBytes))
+        this.nativeCamera.attachRing(new Uint8Array(buffer), slots, streamId, (slot: number) => {
+            const ring = this.rings.get(streamId)
+            if (!ring) return
+            ring.notify()
+            this.emit('ring', ring, slot)
+        })
+
+        const ring = new FrameRing(buffer)
+        this.rings.set(streamId, ring)
+        return ring
+    }
+
+    /**
+     * Stop copying frames into a stream's ring. Workers may keep reading
+     * the frames already in it.
+     */
+    closeFrameRing(streamId: number): void {
+        this.nativeCamera.detachRing(streamId)
+        this.rings.delete(streamId)
+    }
+
     /**
      * Get current control values
      */
@@ -120,6 +423,21 @@ export class Camera extends EventEmitter {
         return this.nativeCamera.getSensorInfo()
     }
 
+    /**
+     * Get runtime counters for this camera instance
+     */
+    getStats(): CameraStats {
+        return this.nativeCamera.getStats()
+    }
+
+    /**
+     * Native camera handle, used by native consumers such as FrameSynchronizer
+     * @internal
+     */
+    get native(): NativeCamera {
+        return this.nativeCamera
+    }
+
     /**
      * Check if camera is currently streaming
      */
@@ -15,11 +15,14 @@ const nodeGypBuild = require('node-gyp-build') as NodeGypBuild;
 
 import { Camera } from './camera.js'
 import { CameraBuilder } from './builder.js'
-import type { NativeAddon, SensorInfo } from './types.js'
+import { FrameSynchronizer } from './sync.js'
+import { FrameRing } from './ring.js'
+import type { CameraInfo, FrameSyncOptions, NativeAddon, SensorInfo } from './types.js'
 
 const addon = nodeGypBuild(join(__dirname, '..')) as NativeAddon
 
-export { Camera, CameraBuilder }
+export { Camera, CameraBuilder, FrameSynchronizer, FrameRing }
+export type { RingFrame } from './ring.js'
 export * from './types.js'
 
 // Export control enums from native addon
@@ -32,6 +35,30 @@ export function builder(): CameraBuilder {
     return new CameraBuilder(addon)
 }
 
+/**
+ * Enumerate connected cameras without acquiring them. Blocks the calling
+ * thread while libcamera's manager starts and stops, typically tens to
+ * hundreds of milliseconds, unless a camera is open and keeps it running.
+ * Call it once at startup and keep the result.
+ */
+export function listCameras(): CameraInfo[] {
+    return addon.listCameras()
+}
+
+/**
+ * Pair frames of two cameras by sensor timestamp
+ */
+export function synchronize(left: Camera, right: Camera, options: FrameSyncOptions = {}): FrameSynchronizer {
+    return new FrameSynchronizer(addon, left, right, options)
+}
+
+/**
+ * Create a synchronizer fed manually through push(), e.g. for testing
+ */
+export function createFrameSynchronizer(options: FrameSyncOptions = {}): FrameSynchronizer {
+    return new FrameSynchronizer(addon, null, null, options)
+}
+
 /**
  * Create simple JPEG camera
  */
@@ -0,0 +1,142 @@
+// ring.ts - Reader for frame rings in a SharedArrayBuffer, usable in workers
+
+// Matches the layout documented in frame_ring.hpp
+const HEADER_BYTES = 64
+const SLOT_HEADER_BYTES = 32
+const ALIGNMENT = 64
+
+const align = (bytes: number) => Math.ceil(bytes / ALIGNMENT) * ALIGNMENT
+
+export interface RingFrame {
+    slot: number
+    data: Uint8Array
+    timestamp: bigint
+    sequence: number
+    streamId: number
+}
+
+/**
+ * Fixed slots of RGB frames shared between the camera and any number of
+ * workers. The native side copies each frame into the next slot and bumps
+ * framesWritten, which readers can block on with wait().
+ *
+ * Slots are guarded by a seqlock: read() copies a slot and returns null if
+ * it was overwritten meanwhile. Zero-copy readers use slotData() and check
+ * version() before and after reading.
+ */
+export class FrameRing {
+    readonly buffer: SharedArrayBuffer
+    private readonly control: Int32Array
+    private readonly versions: Int32Array
+    private readonly words: Uint32Array
+    private readonly stamps: BigUint64Array
+
+    /**
+     * Bytes of shared memory needed for a ring
+     */
+    static bytes(slots: number, frameBytes: number): number {
+        return align(HEADER_BYTES + slots * SLOT_HEADER_BYTES) + slots * align(frameBytes)
+    }
+
+    /**
+     * Open a ring laid out by the camera, e.g. in a worker that received
+     * the buffer through postMessage()
+     */
+    constructor(buffer: SharedArrayBuffer) {
+        this.buffer = buffer
+        this.control = new Int32Array(buffer, 0, HEADER_BYTES / 4)
+        const headerBytes = HEADER_BYTES + this.slots * SLOT_HEADER_BYTES
+        this.versions = new Int32Array(buffer, 0, headerBytes / 4)
+        this.words = new Uint32Array(buffer, 0, headerBytes / 4)
+        this.stamps = new BigUint64Array(buffer, 0, headerBytes / 8)
+    }
+
+    get framesWritten(): number {
+        return Atomics.load(this.control, 0)
+    }
+
+    get slots(): number {
+        return this.control[1]!
+    }
+
+    get slotSize(): number {
+        return this.control[2]!
+    }
+
+    /**
+     * Slot written last, -1 before the first frame
+     */
+    get lastSlot(): number {
+        return Atomics.load(this.control, 4)
+    }
+
+    /**
+     * Block until framesWritten differs from seen. Not allowed on the main
+     * thread, which gets 'ring' events from the camera instead.
+     * @returns false on timeout
+     */
+    wait(seen: number, timeoutMs = Infinity): boolean {
+        return Atomics.wait(this.control, 0, seen, timeoutMs) !== 'timed-out'
+    }
+
+    /**
+     * Wake threads blocked in wait(). Native writes cannot wake them, so
+     * the camera calls this on the main thread for each signal it receives.
+     */
+    notify(): void {
+        Atomics.notify(this.control, 0)
+    }
+
+    /**
+     * Seqlock version of a slot, odd while the camera writes it
+     */
+    version(slot: number): number {
+        return Atomics.load(this.versions, this.wordIndex(slot))
+    }
+
+    /**
+     * View of a slot's pixels without copying, valid while version() is
+     * unchanged
+     */
+    slotData(slot: number): Uint8Array {
+        const offset = this.control[3]! + slot * this.slotSize
+        return new Uint8Array(this.buffer, offset, this.words[this.wordIndex(slot) + 3]!)
+    }
+
+    /**
+     * Copy a slot's frame, into target when given and large enough
+     * @returns null if the slot is empty or was overwritten while copying
+     */
+    read(slot: number, target?: Uint8Array): RingFrame | null {
+        const before = this.version(slot)
+        if (before === 0 || (before & 1) !== 0) return null
+
+        const index = this.wordIndex(slot)
+        const source = this.slotData(slot)
+        const data = target && target.byteLength >= source.byteLength
+            ? target.subarray(0, source.byteLength)
+            : new Uint8Array(source.byteLength)
+        data.set(source)
+
+        const frame: RingFrame = {
+            slot,
+            data,
+            sequence: this.words[index + 1]!,
+            streamId: this.words[index + 2]!,
+            timestamp: this.stamps[index / 2 + 2]!,
+        }
+        return this.version(slot) === before ? frame : null
+    }
+
+    /**
+     * Copy the most recent frame
+     */
+    latest(target?: Uint8Array): RingFrame | null {
+        const slot = this.lastSlot
+        return slot < 0 ? null : this.read(slot, target)
+    }
+
+    private wordIndex(slot: number): number {
+        return (HEADER_BYTES + slot * SLOT_HEADER_BYTES) / 4
+    }
+}
@@ -0,0 +1,51 @@
+// sync.ts - Timestamp-based frame pairing across two cameras
+
+import { EventEmitter } from 'node:events'
+import type { FrameSync as NativeFrameSync, FrameSyncOptions, FrameSyncStats, NativeAddon, PairEvent } from './types.js'
+import type { Camera } from './camera.js'
+
+export interface FrameSynchronizerEvents {
+    pair: [event: PairEvent]
+}
+
+export declare interface FrameSynchronizer {
+    on<K extends keyof FrameSynchronizerEvents>(event: K, listener: (...args: FrameSynchronizerEvents[K]) => void): this
+    emit<K extends keyof FrameSynchronizerEvents>(event: K, ...args: FrameSynchronizerEvents[K]): boolean
+}
+
+/**
+ * Pairs frames of two cameras by sensor timestamp in native code.
+ * Pass null for a side to feed it manually through push().
+ */
+export class FrameSynchronizer extends EventEmitter {
+    private nativeSync: NativeFrameSync
+
+    constructor(addon: NativeAddon, left: Camera | null, right: Camera | null, options: FrameSyncOptions = {}) {
+        super()
+        this.nativeSync = new addon.FrameSync(left?.native ?? null, right?.native ?? null, options, (event) =>
+            this.emit('pair', event),
+        )
+    }
+
+    /**
+     * Feed a frame manually, e.g. from a synthetic source
+     */
+    push(side: 0 | 1, data: Buffer, timestamp: bigint, sequence = 0): void {
+        this.nativeSync.push(side, data, timestamp, sequence)
+    }
+
+    /**
+     * Get pairing counters and the last measured skew
+     */
+    getStats(): FrameSyncStats {
+        return this.nativeSync.getStats()
+    }
+
+    /**
+     * Detach from both cameras
+     */
+    close(): void {
+        this.nativeSync.close()
+        this.removeAllListeners()
+    }
+}
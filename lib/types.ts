@@ -32,9 +32,21 @@ export const enum AwbMode {
 
 // Core types - simple and direct
 export interface StreamConfig {
-  type: 'jpeg' | 'rgb' | 'raw'
+  type: 'jpeg' | 'rgb' | 'raw' | 'still'  // 'still' is held for zero-shutter-lag captureStill()
   width?: number
   height?: number
+  quality?: number  // JPEG and still only - overrides controls.jpegQuality for this stream
+  queueSize?: number         // Overrides CameraConfig.delivery for this stream
+  overflow?: OverflowPolicy
+  pull?: boolean             // Overrides CameraConfig.pull for this stream
+}
+
+// What a full delivery queue does with another frame
+export type OverflowPolicy = 'dropOldest' | 'dropNewest'
+
+export interface DeliveryOptions {
+  queueSize?: number         // Frames per stream waiting for the event loop, defaults to 4
+  overflow?: OverflowPolicy  // Defaults to 'dropOldest'
 }
 
 export interface Controls {
@@ -50,15 +62,44 @@ export interface Controls {
   contrast?: number
   saturation?: number
   sharpness?: number
-  targetFps?: number
+  targetFps?: number       // Fixed frame rate, replaces a range set earlier
+  minFps?: number          // Frame rate range: AE may lengthen frames down to minFps in low light
+  maxFps?: number
+  maxThroughput?: boolean  // Run as fast as the sensor mode allows, ignores maxFps
   jpegQuality?: number
+  // Any other control from getCapabilities().controls, keyed by libcamera name or numeric id
+  extra?: Record<string, ExtraControlValue>
 }
 
+export type ExtraControlValue =
+  | number
+  | boolean
+  | number[]  // Array controls; rectangles and sizes are read back in this form
+  | { x: number; y: number; width: number; height: number }
+  | { width: number; height: number }
+
 export interface CameraConfig {
+  cameraId?: string  // libcamera camera id from listCameras(), defaults to the first camera
   rawStream?: { width?: number; height?: number }
   streams: StreamConfig[]
   controls?: Controls
   jpegEncoderQueueSize?: number
+  earlyDelivery?: boolean  // Dispatch each stream's buffer as soon as it completes
+  zslDepth?: number        // Recent full resolution frames held for captureStill(), defaults to 3
+  stallTimeoutMs?: number  // Emit a STALLED error after this long without frames, 0 disables
+  autoRecover?: boolean    // Stop, reallocate and restart the pipeline after a stall
+  writeAllControls?: boolean  // Write every set control into each request, not only changes; for comparison
+  groupedDelivery?: boolean  // Emit one 'group' event per request instead of per-stream events
+  groupDeadlineMs?: number   // Emit a group without JPEGs still encoding after this long, defaults to 100
+  delivery?: DeliveryOptions // Bounded queues towards JavaScript, groups share one
+  batch?: BatchOptions       // Emit frames in 'batch' events instead of one event each
+  pull?: boolean             // Keep the latest frame per stream for nextFrame() instead of emitting events
+  transferable?: boolean     // JPEG and still Buffers own a copy that postMessage() can transfer, one copy per frame; not RGB
+}
+
+export interface BatchOptions {
+  maxFrames?: number   // Frames of a stream per batch, defaults to 8
+  maxDelayMs?: number  // Longest a frame waits for its batch to fill, defaults to 10
 }
 
 // Frame data
@@ -66,20 +107,87 @@ export interface FrameData {
   data: Buffer
   timestamp: bigint
   sequence: number
+  streamId: number  // Index of the stream in CameraConfig.streams
+  // Indexed by FrameMetadataIndex, NaN when not reported. Frame events of one
+  // camera share a single array, copy it to keep values past the handler.
+  metadata: Float64Array
+}
+
+// Matches FrameMetadata::Field in common.hpp
+export const FrameMetadataIndex = {
+  EXPOSURE_TIME: 0,       // Microseconds
+  ANALOGUE_GAIN: 1,
+  DIGITAL_GAIN: 2,
+  LUX: 3,
+  COLOUR_TEMPERATURE: 4,  // Kelvin
+  FOCUS_FOM: 5,
+  AF_STATE: 6,
+  FRAME_DURATION: 7,      // Microseconds
+  CONTROL_TAG: 8,         // Tag from scheduleControls()/bracket(), 0 if none
+  CROP_X: 9,              // Effective crop as a CropRegion, see setCrop()
+  CROP_Y: 10,
+  CROP_WIDTH: 11,
+  CROP_HEIGHT: 12,
+} as const
+
+export const FRAME_METADATA_FIELDS = 13  // FrameMetadata::FieldCount
+
+// Sensor area scaled into the streams, relative to the largest crop the ISP
+// supports: { x: 0, y: 0, width: 1, height: 1 } is the full field of view
+export interface CropRegion {
+  x?: number
+  y?: number
+  width?: number
+  height?: number
 }
 
 export interface FrameEvent {
   type: 'frame'
-  stream: 'jpeg' | 'rgb' | 'raw'
+  stream: 'jpeg' | 'rgb' | 'raw' | 'still'
   frame: FrameData
 }
 
+export interface PairEvent {
+  type: 'pair'
+  left: FrameData
+  right: FrameData
+  skew: number  // right.timestamp - left.timestamp in nanoseconds
+}
+
 export interface ErrorEvent {
   type: 'error'
   error: string
+  code: ErrorCode
+  stalledMs: number     // STALLED only, age of the stall when detected
+  recovering: boolean   // An automatic restart follows
+  streamId: number      // STALLED only, id of the stream that stalled
+}
+
+export interface StreamFrame extends FrameData {
+  stream: 'jpeg' | 'rgb'
+}
+
+export interface FrameGroupEvent {
+  type: 'group'
+  sequence: number
+  timestamp: bigint
+  complete: boolean      // False if a JPEG missed groupDeadlineMs
+  metadata: Float64Array // Reused like FrameData.metadata
+  frames: StreamFrame[]  // Ordered by streamId
 }
 
-export type CameraEvent = FrameEvent | ErrorEvent
+// Frames of one stream delivered with a single call
+export interface FrameBatchEvent {
+  type: 'batch'
+  stream: 'jpeg' | 'rgb' | 'still'
+  streamId: number
+  data: Buffer[]
+  timestamps: BigUint64Array
+  sequences: Uint32Array
+  metadata: Float64Array  // FrameMetadataIndex values of frame i start at i * FRAME_METADATA_FIELDS
+}
+
+export type CameraEvent = FrameEvent | ErrorEvent | FrameGroupEvent | FrameBatchEvent
 
 // Capabilities
 export interface CapabilityRange {
@@ -88,12 +196,85 @@ export interface CapabilityRange {
   default: number
 }
 
+export interface ControlDescription {
+  id: number
+  type: 'bool' | 'byte' | 'int32' | 'int64' | 'float' | 'string' | 'rectangle' | 'size' | 'unknown'
+  array: boolean
+  size?: number                    // Element count of fixed size arrays
+  min?: number
+  max?: number
+  default?: number
+  values?: Record<string, number>  // Enum controls, e.g. { MeteringCentreWeighted: 0 }
+}
+
 export interface CameraCapabilities {
   exposureTime?: CapabilityRange
   analogueGain?: CapabilityRange
   lensPosition?: CapabilityRange
   afModes: readonly string[]
   awbModes: readonly string[]
+  controls: Record<string, ControlDescription>  // Everything the camera supports, by libcamera name
+}
+
+export interface CameraInfo {
+  id: string
+  model: string
+  location: 'front' | 'back' | 'external' | 'unknown'
+  pixelArrayWidth: number
+  pixelArrayHeight: number
+}
+
+export interface CameraSelector {
+  id?: string
+  model?: string
+  location?: CameraInfo['location']
+}
+
+// Per-instance runtime counters
+export interface CameraStats {
+  cameraId: string
+  requestsCompleted: number
+  achievedFps: number  // From per-frame FrameDuration metadata, smoothed
+  rgbFramesDelivered: number
+  jpegFramesEncoded: number
+  jpegEncodeErrors: number
+  jpegFramesSkipped: number  // Pulled JPEG frames not encoded because nobody asked
+  jpegFramesDropped: number  // Frames an encoder had no queue room for, capture never waits for it
+  jpegQueueDepth: number
+  reconfigures: number
+  lastStartMs: number     // start() until the first frame
+  lastBlackoutMs: number  // reconfigure() until the first frame of the new configuration
+  paused: boolean
+  resumes: number
+  lastResumeMs: number    // resume() until the first frame
+  stillsCaptured: number
+  stillsDropped: number    // Stills of a burst the still encoder had no room for
+  stillQueueDepth: number
+  controlApplies: number      // Requests that received control changes
+  controlsWritten: number     // Controls written to them, unchanged values are skipped
+  controlApplyAvgUs: number   // ControlList population cost per request
+  groupsDelivered: number
+  groupsIncomplete: number  // Groups emitted at the deadline with JPEGs missing
+  requestsInFlight: number
+  stalls: number
+  recoveries: number
+  lastRecoveryMs: number  // Stall detection until the first frame after the restart
+  completionCallbacks: number
+  completionCallbackAvgUs: number  // Time spent on libcamera's completion thread per signal
+  completionCallbackMaxUs: number
+  framesDropped: number       // Frames and groups dropped by full delivery queues
+  delivery: DeliveryQueueStats[]
+  framesDispatched: number    // Frames handed to JavaScript, singly or in batches
+  dispatchAvgNs: number       // Native cost per dispatched frame, JS handlers excluded
+}
+
+export interface DeliveryQueueStats {
+  stream: 'jpeg' | 'rgb' | 'still' | 'group'
+  streamId: number  // -1 for groups
+  queued: number
+  capacity: number
+  delivered: number
+  dropped: number
 }
 
 export interface SensorInfo {
@@ -112,19 +293,105 @@ export interface Dimensions {
 export interface Camera {
   start(): boolean
   stop(): void
+  reconfigure(config: CameraConfig): boolean
+  captureStill(at?: bigint): boolean
+  pause(): boolean
+  resume(): boolean
   setControls(controls: Controls): boolean
+  scheduleControls(controls: Controls, framesAhead?: number): number
+  bracket(sets: Controls[]): number[]
+  setCrop(region: CropRegion, transitionFrames?: number): boolean
   getControls(): Controls
   getCapabilities(): CameraCapabilities
   getSensorInfo(): SensorInfo
-  on(event: string, callback: (event: CameraEvent) => void): void
+  getStats(): CameraStats
+  isRunning(): boolean
+  // One handler per channel, replaced by a later on(). 'frame' receives
+  // the streams and errors that have no handler of their own.
+  on(event: NativeChannel, callback: NativeCallback): void
+  off(event: NativeChannel): void
+  frameLayout(streamId: number): FrameLayout | undefined
+  // Copies each frame of an RGB stream into the ring laid out over memory;
+  // callback gets the slot written, coalesced while one is pending
+  attachRing(memory: Uint8Array, slots: number, streamId: number, callback: (slot: number) => void): void
+  detachRing(streamId: number): void
+  nextFrame(streamId: number): Promise<FrameData>
+  // Lifecycle on the thread pool, settled with the phases' timings
+  initialize(): Promise<LifecycleTimings>
+  startAsync(firstFrameTimeoutMs?: number): Promise<LifecycleTimings>
+  stopAsync(): Promise<LifecycleTimings>
+  reconfigureAsync(config: CameraConfig, firstFrameTimeoutMs?: number): Promise<LifecycleTimings>
+}
+
+// Milliseconds per phase of an async lifecycle operation, 0 for phases it skipped
+export interface LifecycleTimings {
+  managerStartMs: number   // Process-wide libcamera manager
+  acquireMs: number
+  configureMs: number      // Stream configuration, encoders and controls
+  allocateMs: number       // Buffer allocation and mapping
+  startMs: number          // Starting the camera and queueing requests
+  firstFrameMs: number | null  // Start until the first frame, null if it did not arrive in time
+  stopMs: number
+  totalMs: number          // Whole operation on the worker thread
+}
+
+// Geometry of a configured stream
+export interface FrameLayout {
+  stream: 'jpeg' | 'rgb' | 'raw' | 'still'
+  width: number
+  height: number
+  stride: number      // Bytes per line
+  frameBytes: number  // Largest uncompressed frame
+}
+
+export type NativeChannel = 'jpeg' | 'rgb' | 'still' | 'group' | 'frame' | 'error'
+
+// Single frames arrive as positional arguments, everything else as an event
+// object. Stream types are indexed by NATIVE_STREAM_TYPES.
+export type NativeCallback = {
+  (event: FrameGroupEvent | FrameBatchEvent | ErrorEvent): void
+  (streamType: number, data: Buffer, timestamp: bigint, sequence: number, streamId: number, metadata: Float64Array): void
 }
 
+// Matches lcam::StreamType in common.hpp
+export const NATIVE_STREAM_TYPES = ['jpeg', 'rgb', 'raw', 'still'] as const
+
 export interface CameraConstructor {
-  new (config: CameraConfig): Camera
+  // deferInitialize leaves acquiring and configuring to initialize()
+  new (config: CameraConfig, deferInitialize?: boolean): Camera
+}
+
+// Frame synchronizer
+export interface FrameSyncOptions {
+  stream?: 'jpeg' | 'rgb'  // Stream type to pair, defaults to 'rgb'
+  streamId?: number        // Restrict pairing to one stream of that type
+  toleranceUs?: number     // Maximum timestamp difference of a pair, defaults to 5000
+  maxPending?: number      // Frames queued per side while the other lags, defaults to 4
+}
+
+export interface FrameSyncStats {
+  pairs: number
+  droppedLeft: number
+  droppedRight: number
+  lastSkew: number  // Nanoseconds
+  pairsDropped: number  // Pairs dropped while the event loop was behind
+}
+
+export interface FrameSync {
+  push(side: 0 | 1, data: Buffer, timestamp: bigint, sequence?: number): void
+  getStats(): FrameSyncStats
+  close(): void
+}
+
+export interface FrameSyncConstructor {
+  new (left: Camera | null, right: Camera | null, options: FrameSyncOptions,
+       callback: (event: PairEvent) => void): FrameSync
 }
 
 export interface NativeAddon {
   Camera: CameraConstructor
+  listCameras(): CameraInfo[]
+  FrameSync: FrameSyncConstructor
   controls: {
     ExposureMode: typeof ExposureMode
     AfMode: typeof AfMode
@@ -143,12 +410,23 @@ export const ErrorCodes = {
   INVALID_EXPOSURE: 'INVALID_EXPOSURE',
   INVALID_GAIN: 'INVALID_GAIN',
   NO_STREAMS: 'NO_STREAMS',
+  CAMERA_NOT_FOUND: 'CAMERA_NOT_FOUND',
+  STALLED: 'STALLED',
+  RECOVERY_FAILED: 'RECOVERY_FAILED',
+  RECONFIGURE_FAILED: 'RECONFIGURE_FAILED',
+  UNKNOWN: 'UNKNOWN',
 } as const
 
 export type ErrorCode = typeof ErrorCodes[keyof typeof ErrorCodes]
 
 export class CameraError extends Error {
-  constructor(message: string, public readonly code?: ErrorCode) {
+  constructor(
+    message: string,
+    public readonly code?: ErrorCode,
+    public readonly stalledMs?: number,
+    public readonly recovering?: boolean,
+    public readonly streamId?: number
+  ) {
     super(message)
     this.name = 'CameraError'
   }
@@ -163,6 +441,14 @@ export function isErrorEvent(event: CameraEvent): event is ErrorEvent {
   return event.type === 'error'
 }
 
+export function isFrameGroupEvent(event: CameraEvent): event is FrameGroupEvent {
+  return event.type === 'group'
+}
+
+export function isFrameBatchEvent(event: CameraEvent): event is FrameBatchEvent {
+  return event.type === 'batch'
+}
+
 // Validation helpers
 export function validateDimensions(width: number, height: number): void {
   if (width <= 0 || width > 8192) {
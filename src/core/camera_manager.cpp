@@ -1,17 +1,39 @@
 #include "camera_manager.hpp"
 #include "stream_manager.hpp"
 #include "jpeg_encoder.hpp"
+#include "shared_camera_manager.hpp"
+#include "spsc_queue.hpp"
 #include <iostream>
 #include <algorithm>
+#include <map>
+#include <deque>
+#include <chrono>
+#include <thread>
+#include <condition_variable>
+#include <sstream>
+#include <cmath>
+#include <utility>
 
 namespace lcam {
 
 class CameraManager::Impl {
 public:
-    Impl() : lcManager_(std::make_unique<lc::CameraManager>()) {}
+    Impl() = default;
+
+    ~Impl() {
+        stop();
+        if (streamManager_) streamManager_->freeBuffers();
+        if (camera_ && acquired_) camera_->release();
+        delete pendingControls_.exchange(nullptr);
+    }
 
     bool initialize(const CameraConfig& config) {
-        if (lcManager_->start() < 0) {
+        resetTimings();
+        int64_t mark = nowNs();
+
+        lcManager_ = SharedCameraManager::acquire();
+        mark = recordPhase(&LifecycleTimings::managerStartMs, mark);
+        if (!lcManager_) {
             lastError_ = "Failed to start camera manager. Check if camera service is running.";
             return false;
         }
@@ -22,91 +44,356 @@ public:
             return false;
         }
 
-        // Use the first available camera
-        camera_ = cameras[0];
+        // Use the requested camera, or the first available one
+        if (config.cameraId.empty()) {
+            camera_ = cameras[0];
+        } else {
+            camera_ = lcManager_->get(config.cameraId);
+            if (!camera_) {
+                lastError_ = "Camera '" + config.cameraId + "' not found.";
+                return false;
+            }
+        }
+
         if (camera_->acquire()) {
             lastError_ = "Failed to acquire camera. Camera may be in use by another process.";
             return false;
         }
+        acquired_ = true;
+        cameraId_ = camera_->id();
+        mark = recordPhase(&LifecycleTimings::acquireMs, mark);
 
         streamManager_ = std::make_unique<StreamManager>(camera_);
-        if (!streamManager_->configure(config.rawStream, config.streams)) {
+        if (!streamManager_->configure(config.rawStream, config.streams, heldRequests(config))) {
             lastError_ = "Failed to configure streams. Check requested resolutions and formats.";
             return false;
         }
 
         controlManager_ = std::make_unique<ControlManager>(camera_);
-        jpegEncoder_ = std::make_unique<JpegEncoder>(config.jpegEncoderQueueSize);
+        controlManager_->setWriteAll(config.writeAllControls);
+        createJpegStreams(config);
+        readCropMaximum();
+        recordPhase(&LifecycleTimings::configureMs, mark);
 
+        config_ = config;
         initialControls_ = config.initialControls;
+        earlyDelivery_ = config.earlyDelivery;
+        grouped_ = config.groupedDelivery && !config.earlyDelivery;
+        groupDeadlineNs_ = static_cast<int64_t>(config.groupDeadlineMs) * 1000000;
+        stallTimeoutMs_ = config.stallTimeoutMs;
+        autoRecover_ = config.autoRecover;
 
         return true;
     }
 
-    bool start(const FrameCallback &frameCallback, ErrorCallback errorCallback) {
+    bool start(const FrameCallback &frameCallback, ErrorCallback errorCallback, GroupCallback groupCallback) {
+        std::lock_guard lifecycle(lifecycleMutex_);
+        if (running_) return true;
+
         frameCallback_ = frameCallback;
         errorCallback_ = errorCallback;
+        groupCallback_ = groupCallback;
+        deliverCallback_ = [this](StreamType type, const Frame& frame) { deliver(type, frame); };
+        groupMemberCallback_ = [this](StreamType type, const Frame& frame) { addToGroup(type, frame); };
 
-        if (!streamManager_->allocateBuffers()) {
-            errorCallback_("Failed to allocate buffers. Insufficient memory or invalid configuration.");
-            return false;
+        resetTimings();
+        startMarkNs_ = nowNs();
+        if (!startStreaming()) return false;
+
+        startWatchdog();
+        return true;
+    }
+
+    bool captureStill(uint64_t at) {
+        if (!running_ || !zslStream_) return false;
+
+        std::lock_guard lock(zslMutex_);
+        if (zslRing_.empty() || !stillsRunning_) return false;
+
+        // Newest frame by default, otherwise the one closest to the timestamp
+        auto best = std::prev(zslRing_.end());
+        if (at) {
+            best = std::min_element(zslRing_.begin(), zslRing_.end(), [at](const auto& a, const auto& b) {
+                const uint64_t da = a.timestamp > at ? a.timestamp - at : at - a.timestamp;
+                const uint64_t db = b.timestamp > at ? b.timestamp - at : at - b.timestamp;
+                return da < db;
+            });
         }
 
-        jpegEncoder_->start();
+        // Checked out of the ring, the still thread copies and requeues it
+        stillQueue_.push_back(*best);
+        zslRing_.erase(best);
+        stillCv_.notify_one();
+        return true;
+    }
+
+    bool reconfigure(const CameraConfig& config) {
+        std::lock_guard lifecycle(lifecycleMutex_);
+        resetTimings();
+        const int64_t mark = nowNs();
 
-        // Connect to request completion signal
-        camera_->requestCompleted.connect(this, &Impl::requestComplete);
+        if (!config.cameraId.empty() && config.cameraId != cameraId_) {
+            lastError_ = "Reconfigure cannot switch cameras. Create a new camera instead.";
+            return false;
+        }
 
-        // Set default values if not specified
-        lc::ControlList startControls;
-        if (!initialControls_.targetFps) {
-            initialControls_.targetFps = 30;
+        const bool wasRunning = running_;
+        stopStreaming();
+        const int64_t configureMark = recordPhase(&LifecycleTimings::stopMs, mark);
+
+        const CameraConfig previous = config_;
+        const bool newStreams = !configured() || !sameStreams(config, config_);
+        if (!newStreams) {
+            // Geometry unchanged, keep buffers, mappings and encoders
+            for (const auto& [stream, info] : streamManager_->streams()) {
+                if (info.type == StreamType::JPEG) {
+                    auto& jpeg = *jpegStreams_.at(stream);
+                    jpeg.fixedQuality = config.streams[info.id].quality;
+                    jpeg.onDemand = config.streams[info.id].onDemand;
+                } else if (info.type == StreamType::STILL) {
+                    stillQuality_ = config.streams[info.id].quality.value_or(95);
+                }
+            }
+        } else if (!configureStreams(config)) {
+            return restoreStreams(previous, wasRunning);
         }
-        if (!initialControls_.jpegQuality) {
-            initialControls_.jpegQuality = 85;
+
+        adoptConfig(config);
+        reconfigures_.fetch_add(1, std::memory_order_relaxed);
+        recordPhase(&LifecycleTimings::configureMs, configureMark);
+
+        if (!wasRunning) return true;
+
+        blackoutMarkNs_ = mark;
+        startMarkNs_ = nowNs();
+        if (!startStreaming()) {
+            // Allocation or start failed, possibly because of the new streams
+            return newStreams ? restoreStreams(previous, true) : false;
         }
 
-        if (camera_->start(&startControls) < 0) {
-            errorCallback_("Failed to start camera capture. Check camera permissions.");
+        startWatchdog();
+        return true;
+    }
+
+    /**
+     * Configure new streams along with their encoders and the controls
+     * their sensor mode supports
+     */
+    bool configureStreams(const CameraConfig& config) {
+        // Buffers must be released before libcamera accepts a new configuration
+        streamManager_->freeBuffers();
+        buffersAllocated_ = false;
+
+        if (!streamManager_->configure(config.rawStream, config.streams, heldRequests(config))) {
+            lastError_ = "Failed to configure streams. Check requested resolutions and formats.";
+
+            // No encoder may outlive the streams it was created for
+            jpegStreams_.clear();
+            zslStream_ = nullptr;
+            stillEncoder_.reset();
             return false;
         }
 
-        // Apply initial controls to all requests
-        for (auto& request : streamManager_->requests()) {
-            controlManager_->applyControls(initialControls_, request.get());
+        createJpegStreams(config);
+        controlManager_->reloadTable();
+        return true;
+    }
+
+    /**
+     * Streams were configured successfully and not torn down by a failure since
+     */
+    bool configured() const {
+        return !streamManager_->streams().empty();
+    }
+
+    void adoptConfig(const CameraConfig& config) {
+        config_ = config;
+        config_.cameraId = cameraId_;
+        initialControls_ = config.initialControls;
+        earlyDelivery_ = config.earlyDelivery;
+        grouped_ = config.groupedDelivery && !config.earlyDelivery;
+        groupDeadlineNs_ = static_cast<int64_t>(config.groupDeadlineMs) * 1000000;
+        stallTimeoutMs_ = config.stallTimeoutMs;
+        autoRecover_ = config.autoRecover;
+        controlManager_->setWriteAll(config.writeAllControls);
+    }
+
+    /**
+     * Go back to the configuration that was active before a failed
+     * reconfigure and restart capture if it was running. If even that
+     * fails no stream is configured, and start() fails until a later
+     * reconfigure succeeds.
+     * @return Always false, lastError() describes the failure
+     */
+    bool restoreStreams(const CameraConfig& previous, bool restart) {
+        const std::string error = lastError_;
+
+        if (!configureStreams(previous)) {
+            lastError_ = error + " Restoring the previous configuration failed as well.";
+        } else {
+            adoptConfig(previous);
+            lastError_ = error + " The previous configuration was restored.";
+
+            if (restart) {
+                startMarkNs_ = nowNs();
+                if (startStreaming()) {
+                    startWatchdog();
+                } else {
+                    lastError_ = error + " The previous configuration was restored but failed to start.";
+                }
+            }
         }
 
-        jpegQuality_ = initialControls_.jpegQuality.value_or(85);
+        // Set once the camera was started
+        if (errorCallback_) errorCallback_({ErrorCode::ReconfigureFailed, lastError_});
+        return false;
+    }
 
-        streamManager_->queueRequests();
-        running_ = true;
+    uint32_t addFrameListener(FrameCallback listener) {
+        std::lock_guard lock(listenerMutex_);
+        const uint32_t id = nextListenerId_++;
+        listeners_.emplace_back(id, std::move(listener));
+        hasListeners_ = true;
+        return id;
+    }
 
-        return true;
+    void removeFrameListener(uint32_t id) {
+        std::lock_guard lock(listenerMutex_);
+        std::erase_if(listeners_, [id](const auto& entry) { return entry.first == id; });
+        hasListeners_ = !listeners_.empty();
     }
 
     void stop() {
+        // Joined first, a recovery in progress holds the lifecycle lock
+        stopWatchdog();
+
+        std::lock_guard lifecycle(lifecycleMutex_);
         if (!running_) return;
 
-        running_ = false;
-        camera_->requestCompleted.disconnect(this, &Impl::requestComplete);
-        camera_->stop();
+        resetTimings();
+        const int64_t mark = nowNs();
+        stopStreaming();
+        recordPhase(&LifecycleTimings::stopMs, mark);
+    }
 
-        jpegEncoder_->stop();
-        streamManager_->freeBuffers();
+    LifecycleTimings getTimings() {
+        std::lock_guard lock(timingsMutex_);
+        return timings_;
+    }
+
+    bool isRunning() const {
+        return running_;
+    }
+
+    bool waitForFirstFrame(uint32_t timeoutMs) {
+        std::unique_lock lock(firstFrameMutex_);
+        firstFrameCv_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                               [this] { return !startMarkNs_.load(std::memory_order_relaxed); });
+
+        std::lock_guard timings(timingsMutex_);
+        return timings_.firstFrameMs > 0;
+    }
+
+    std::string lastError() const {
+        return lastError_;
+    }
+
+    bool pause() {
+        if (!running_) return false;
+
+        // Completed requests get parked instead of requeued from now on
+        paused_ = true;
+        return true;
+    }
 
-        camera_->release();
-        camera_.reset();
+    bool resume() {
+        if (!running_) return false;
+
+        std::lock_guard lock(parkMutex_);
+        if (!paused_) return true;
+
+        resumeMarkNs_ = nowNs();
+        paused_ = false;
+
+        for (auto* request : parked_) {
+            countQueued(request);
+            camera_->queueRequest(request);
+        }
+        requestsInFlight_.fetch_add(parked_.size(), std::memory_order_relaxed);
+        parked_.clear();
+
+        return true;
     }
 
     bool setControls(const Controls& controls) {
+        // Serialises writers only, the completion path never takes it
         std::lock_guard lock(controlMutex_);
 
-        // JPEG quality is handled separately from camera controls
+        // JPEG quality is handled separately from camera controls and only
+        // affects streams that did not pin their own quality
         if (controls.jpegQuality) {
-            jpegQuality_ = *controls.jpegQuality;
+            for (auto& [stream, jpeg] : jpegStreams_) {
+                if (!jpeg->fixedQuality) jpeg->quality = *controls.jpegQuality;
+            }
+        }
+
+        // Fold in changes from an earlier call that no request picked up yet
+        auto next = std::make_unique<Controls>();
+        if (std::unique_ptr<Controls> unapplied{pendingControls_.exchange(nullptr, std::memory_order_acq_rel)}) {
+            *next = *unapplied;
+        }
+        mergeControls(*next, controls);
+
+        pendingControls_.store(next.release(), std::memory_order_release);
+        return true;
+    }
+
+    uint32_t scheduleControls(const Controls& controls, uint32_t framesAhead) {
+        std::lock_guard lock(scheduleMutex_);
+
+        const uint32_t tag = nextControlTag_++;
+        const uint64_t index = queueIndex_.load(std::memory_order_acquire) + framesAhead;
+
+        // A later schedule for the same request adds to the earlier one
+        auto& entry = schedule_[index];
+        mergeControls(entry.controls, controls);
+        entry.tag = tag;
+
+        hasSchedule_.store(true, std::memory_order_release);
+        return tag;
+    }
+
+    std::vector<uint32_t> setBracket(const std::vector<Controls>& sets) {
+        if (sets.empty()) {
+            bracket_.store(nullptr, std::memory_order_release);
+            bracketChanged_.store(true, std::memory_order_release);
+            return {};
+        }
+
+        auto bracket = std::make_shared<Bracket>();
+        bracket->sets = sets;
+        {
+            std::lock_guard lock(scheduleMutex_);
+            for (size_t i = 0; i < sets.size(); i++) bracket->tags.push_back(nextControlTag_++);
         }
 
-        pendingControls_ = controls;
+        bracket_.store(bracket, std::memory_order_release);
+        bracketChanged_.store(true, std::memory_order_release);
+        return bracket->tags;
+    }
+
+    bool setCrop(const CropRegion& region, uint32_t transitionFrames) {
+        if (!cropSupported_) return false;
+
+        // Also rejects NaN
+        constexpr double slack = 1e-9;
+        const bool valid = region.width > 0 && region.height > 0 && region.x >= 0 && region.y >= 0 &&
+                           region.x + region.width <= 1 + slack && region.y + region.height <= 1 + slack;
+        if (!valid) return false;
+
+        cropTarget_.store(std::make_shared<const CropTransition>(CropTransition{region, transitionFrames}),
+                          std::memory_order_release);
+        cropChanged_.store(true, std::memory_order_release);
         return true;
     }
 
@@ -118,110 +405,1421 @@ public:
         return controlManager_->getCapabilities();
     }
 
+    bool requestFrame(uint32_t streamId) {
+        for (auto& [stream, jpeg] : jpegStreams_) {
+            if (streamManager_->getStreamInfo(stream)->id != streamId) continue;
+            if (!jpeg->onDemand) return false;
+
+            jpeg->demanded.store(true, std::memory_order_release);
+            return true;
+        }
+        return false;
+    }
+
+    std::optional<StreamLayout> getStreamLayout(uint32_t streamId) const {
+        for (const auto& [stream, info] : streamManager_->streams()) {
+            if (info.id != streamId) continue;
+            return StreamLayout{info.type, info.width, info.height, info.stride,
+                                static_cast<size_t>(info.stride) * info.height};
+        }
+        return std::nullopt;
+    }
+
+    CameraStats getStats() const {
+        CameraStats stats;
+        stats.cameraId = cameraId_;
+        stats.requestsCompleted = requestsCompleted_;
+        stats.achievedFps = achievedFps_;
+        stats.rgbFramesDelivered = rgbFramesDelivered_;
+        stats.reconfigures = reconfigures_;
+        stats.lastStartMs = lastStartMs_;
+        stats.lastBlackoutMs = lastBlackoutMs_;
+        stats.paused = paused_;
+        stats.resumes = resumes_;
+        stats.lastResumeMs = lastResumeMs_;
+        stats.stillsCaptured = stillsCaptured_;
+        if (stillEncoder_) {
+            stats.stillsDropped = stillEncoder_->framesDropped();
+            stats.stillQueueDepth = stillEncoder_->queueDepth();
+        }
+        const auto apply = controlManager_->getApplyStats();
+        stats.controlApplies = apply.applies;
+        stats.controlsWritten = apply.controlsWritten;
+        if (apply.applies) {
+            stats.controlApplyAvgUs = static_cast<double>(apply.totalNs) / 1e3 / apply.applies;
+        }
+        stats.groupsDelivered = groupsDelivered_;
+        stats.groupsIncomplete = groupsIncomplete_;
+        stats.requestsInFlight = std::max<int64_t>(requestsInFlight_, 0);
+        stats.stalls = stalls_;
+        stats.recoveries = recoveries_;
+        stats.lastRecoveryMs = lastRecoveryMs_;
+        stats.completionCallbacks = callbacks_;
+        stats.completionCallbackMaxUs = static_cast<double>(callbackNsMax_) / 1e3;
+        if (stats.completionCallbacks) {
+            stats.completionCallbackAvgUs = static_cast<double>(callbackNsTotal_) / 1e3 / stats.completionCallbacks;
+        }
+
+        for (const auto& [stream, jpeg] : jpegStreams_) {
+            stats.jpegFramesEncoded += jpeg->encoder.framesEncoded();
+            stats.jpegEncodeErrors += jpeg->encoder.encodeErrors();
+            stats.jpegFramesSkipped += jpeg->framesSkipped;
+            stats.jpegFramesDropped += jpeg->encoder.framesDropped();
+            stats.jpegQueueDepth += jpeg->encoder.queueDepth();
+        }
+
+        return stats;
+    }
+
 private:
     /**
-     * Called by libcamera when a capture request completes
+     * Request or single buffer (early delivery) handed to the dispatch thread
      */
-    void requestComplete(lc::Request* request) {
-        if (request->status() == lc::Request::RequestCancelled) return;
+    struct Completion {
+        lc::Request* request = nullptr;
+        lc::FrameBuffer* buffer = nullptr;  // Set for early delivered buffers only
+        uint64_t timestamp = 0;
+        uint32_t sequence = 0;
+    };
 
-        // Apply any pending control changes
-        {
-            std::lock_guard lock(controlMutex_);
-            if (pendingControls_.has_value()) {
-                controlManager_->applyControls(*pendingControls_, request);
-                pendingControls_.reset();
+    static int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * Copy the per-frame results consumers need out of the request metadata
+     */
+    FrameMetadata readMetadata(const lc::ControlList& list) const {
+        FrameMetadata metadata;
+
+        auto read = [&](FrameMetadata::Field field, const auto& value) {
+            if (value) metadata.values[field] = static_cast<double>(*value);
+        };
+
+        read(FrameMetadata::ExposureTime, list.get(lc::controls::ExposureTime));
+        read(FrameMetadata::AnalogueGain, list.get(lc::controls::AnalogueGain));
+        read(FrameMetadata::DigitalGain, list.get(lc::controls::DigitalGain));
+        read(FrameMetadata::Lux, list.get(lc::controls::Lux));
+        read(FrameMetadata::ColourTemperature, list.get(lc::controls::ColourTemperature));
+        read(FrameMetadata::FocusFoM, list.get(lc::controls::FocusFoM));
+        read(FrameMetadata::AfState, list.get(lc::controls::AfState));
+        read(FrameMetadata::FrameDuration, list.get(lc::controls::FrameDuration));
+
+        if (const auto crop = list.get(lc::controls::ScalerCrop); crop && cropSupported_) {
+            const double width = cropMaximum_.width;
+            const double height = cropMaximum_.height;
+            metadata.values[FrameMetadata::CropX] = (crop->x - cropMaximum_.x) / width;
+            metadata.values[FrameMetadata::CropY] = (crop->y - cropMaximum_.y) / height;
+            metadata.values[FrameMetadata::CropWidth] = crop->width / width;
+            metadata.values[FrameMetadata::CropHeight] = crop->height / height;
+        }
+
+        return metadata;
+    }
+
+    /**
+     * Crop regions are relative to ScalerCropMaximum, which libcamera updates
+     * when the sensor mode changes with a new configuration
+     */
+    void readCropMaximum() {
+        cropMaximum_ = camera_->properties().get(lc::properties::ScalerCropMaximum).value_or(lc::Rectangle{});
+        cropSupported_ = cropMaximum_.width && cropMaximum_.height &&
+                         controlManager_->table().find(lc::controls::ScalerCrop.id());
+    }
+
+    /**
+     * Sensor rectangle for a crop region
+     */
+    lc::Rectangle toSensorCrop(const CropRegion& region) const {
+        auto scale = [](double value, unsigned int size) { return static_cast<int>(std::lround(value * size)); };
+        const int width = std::max(scale(region.width, cropMaximum_.width), 1);
+        const int height = std::max(scale(region.height, cropMaximum_.height), 1);
+        return lc::Rectangle(cropMaximum_.x + scale(region.x, cropMaximum_.width),
+                             cropMaximum_.y + scale(region.y, cropMaximum_.height),
+                             static_cast<unsigned int>(width), static_cast<unsigned int>(height));
+    }
+
+    /**
+     * Streams only need a libcamera reconfiguration when their geometry changes
+     */
+    static bool sameStreams(const CameraConfig& a, const CameraConfig& b) {
+        auto same = [](const StreamConfig& x, const StreamConfig& y) {
+            return x.type == y.type && x.width == y.width && x.height == y.height;
+        };
+
+        if (a.rawStream.has_value() != b.rawStream.has_value()) return false;
+        if (a.rawStream && !same(*a.rawStream, *b.rawStream)) return false;
+        if (a.streams.size() != b.streams.size()) return false;
+        if (a.jpegEncoderQueueSize != b.jpegEncoderQueueSize) return false;
+        if (heldRequests(a) != heldRequests(b)) return false;
+
+        return std::equal(a.streams.begin(), a.streams.end(), b.streams.begin(), same);
+    }
+
+    /**
+     * Extra requests needed so the ZSL ring never starves capture
+     */
+    static size_t heldRequests(const CameraConfig& config) {
+        const bool zsl = std::any_of(config.streams.begin(), config.streams.end(),
+                                     [](const auto& stream) { return stream.type == StreamType::STILL; });
+        return zsl ? config.zslDepth : 0;
+    }
+
+    /**
+     * One encoder per JPEG stream so each keeps its own geometry and quality
+     */
+    void createJpegStreams(const CameraConfig& config) {
+        jpegStreams_.clear();
+        zslStream_ = nullptr;
+        stillEncoder_.reset();
+
+        for (const auto& [stream, info] : streamManager_->streams()) {
+            if (info.type == StreamType::STILL) {
+                // Spare worker so stills never queue behind preview frames
+                zslStream_ = stream;
+                zslDepth_ = config.zslDepth;
+                stillQuality_ = config.streams[info.id].quality.value_or(95);
+                stillEncoder_ = std::make_unique<JpegEncoder>(2);
+                continue;
             }
+
+            if (info.type != StreamType::JPEG) continue;
+
+            auto jpeg = std::make_unique<JpegStream>(config.jpegEncoderQueueSize);
+            jpeg->fixedQuality = config.streams[info.id].quality;
+            jpeg->onDemand = config.streams[info.id].onDemand;
+            jpegStreams_[stream] = std::move(jpeg);
         }
+    }
 
-        // Extract frame metadata
-        uint32_t sequence = request->sequence();
-        uint64_t timestamp = request->metadata().get(lc::controls::SensorTimestamp)
-                                              .value_or(0);
+    /**
+     * Start capture on the acquired and configured camera. Buffers and their
+     * mappings from a previous run are reused.
+     */
+    bool startStreaming() {
+        int64_t mark = nowNs();
+        if (!configured()) {
+            lastError_ = "No streams configured, the last reconfigure failed. Reconfigure the camera first.";
+            errorCallback_({ErrorCode::StartFailed, lastError_});
+            return false;
+        }
+        if (!buffersAllocated_) {
+            if (!streamManager_->allocateBuffers()) {
+                // Partly allocated buffers would make the next attempt fail too
+                streamManager_->freeBuffers();
+                lastError_ = "Failed to allocate buffers. Insufficient memory or invalid configuration.";
+                errorCallback_({ErrorCode::StartFailed, lastError_});
+                return false;
+            }
+            buffersAllocated_ = true;
+            mark = recordPhase(&LifecycleTimings::allocateMs, mark);
+        }
+        readCropMaximum();
 
-        // Process each stream in the request
-        for (auto& [stream, buffer] : request->buffers()) {
-            auto type = streamManager_->getStreamType(stream);
-
-            if (type == StreamType::RAW) continue;  // Skip RAW processing
-
-            const uint8_t* data = streamManager_->getMappedData(buffer);
-            size_t size = streamManager_->getMappedSize(buffer);
-
-            if (!data) continue;
-
-            if (type == StreamType::RGB) {
-                // Direct delivery for RGB frames
-                Frame frame{
-                    std::span(data, size),
-                    timestamp,
-                    sequence,
-                    nullptr
-                };
-                frameCallback_(StreamType::RGB, frame);
-            } else if (type == StreamType::JPEG) {
-                // Queue for async JPEG encoding
-                jpegEncoder_->encode(
-                    data,
-                    streamManager_->getJpegWidth(),
-                    streamManager_->getJpegHeight(),
-                    jpegQuality_,
-                    timestamp,
-                    sequence,
-                    frameCallback_
-                );
+        for (auto& [stream, jpeg] : jpegStreams_) {
+            jpeg->encoder.start();
+        }
+        if (stillEncoder_) stillEncoder_->start();
+        startStillThread();
+        startDispatcher();
+        startGroupTimer();
+
+        // Connect to completion signals; buffers are dispatched individually
+        // in early delivery mode, otherwise once the whole request is done
+        camera_->requestCompleted.connect(this, &Impl::requestComplete);
+        if (earlyDelivery_) {
+            camera_->bufferCompleted.connect(this, &Impl::bufferComplete);
+        }
+
+        // Set default values if not specified
+        lc::ControlList startControls;
+        const auto& c = initialControls_;
+        if (!c.targetFps && !c.minFps && !c.maxFps && !c.maxThroughput) {
+            initialControls_.targetFps = 30;
+        }
+        if (!initialControls_.jpegQuality) {
+            initialControls_.jpegQuality = 85;
+        }
+
+        if (camera_->start(&startControls) < 0) {
+            disconnectSignals();
+            stopDispatcher();
+            stopGroupTimer();
+            stopStillThread();
+            for (auto& [stream, jpeg] : jpegStreams_) {
+                jpeg->encoder.stop();
             }
+            lastError_ = "Failed to start camera capture. Check camera permissions.";
+            errorCallback_({ErrorCode::StartFailed, lastError_});
+            return false;
         }
 
-        // Reuse request for next capture
-        request->reuse(lc::Request::ReuseBuffers);
-        camera_->queueRequest(request);
+        // Apply initial controls to all requests, which may still carry
+        // the cancelled state of a previous run. Only the first request
+        // carries the full control set, the pipeline keeps it from there.
+        controlManager_->invalidate();
+        for (auto& request : streamManager_->requests()) {
+            request->reuse(lc::Request::ReuseBuffers);
+            controlManager_->applyControls(initialControls_, request.get());
+        }
+
+        // The pipeline starts uncropped, carry the zoom over restarts
+        if (cropSupported_ && cropCurrent_ != CropRegion{}) {
+            streamManager_->requests().front()->controls().set(lc::controls::ScalerCrop,
+                                                              toSensorCrop(cropCurrent_));
+        }
+
+        for (auto& [stream, jpeg] : jpegStreams_) {
+            jpeg->quality = jpeg->fixedQuality.value_or(*initialControls_.jpegQuality);
+        }
+
+        // Requests start without scheduled controls, the schedule counts
+        // from the first requeue
+        requestTags_.assign(streamManager_->requests().size(), 0);
+
+        // The watchdog measures stalls from here until the first completion.
+        // Built while the camera is stopped, completions only update it.
+        const int64_t queuedNs = nowNs();
+        streamActivity_.clear();
+        for (const auto& [stream, info] : streamManager_->streams()) {
+            streamActivity_[stream].lastCompletionNs = queuedNs;
+        }
+        for (auto& request : streamManager_->requests()) {
+            countQueued(request.get());
+        }
+        requestsInFlight_ = static_cast<int64_t>(streamManager_->requests().size());
+
+        streamManager_->queueRequests();
+        running_ = true;
+        recordPhase(&LifecycleTimings::startMs, mark);
+
+        return true;
     }
 
-    std::unique_ptr<lc::CameraManager> lcManager_;
-    std::shared_ptr<lc::Camera> camera_;
-    std::unique_ptr<StreamManager> streamManager_;
-    std::unique_ptr<JpegEncoder> jpegEncoder_;
-    std::unique_ptr<ControlManager> controlManager_;
+    /**
+     * Stop capture but keep the camera acquired and the buffers mapped
+     */
+    void stopStreaming() {
+        if (!running_) return;
 
-    FrameCallback frameCallback_;
-    ErrorCallback errorCallback_;
+        running_ = false;
+        disconnectSignals();
+        stopDispatcher();
+        stopGroupTimer();
+        stopStillThread();
+        camera_->stop();
 
-    Controls initialControls_;
-    std::optional<Controls> pendingControls_;  // Controls waiting to be applied
-    std::mutex controlMutex_;
+        // Parked and held requests are requeued with all others on the next start
+        {
+            std::lock_guard lock(parkMutex_);
+            paused_ = false;
+            parked_.clear();
+        }
+        {
+            std::lock_guard lock(zslMutex_);
+            zslRing_.clear();
+        }
 
-    std::atomic<int> jpegQuality_{85};
-    bool running_ = false;
-    std::string lastError_;
-};
+        for (auto& [stream, jpeg] : jpegStreams_) {
+            jpeg->encoder.stop();
+        }
 
-// Public interface implementation
-CameraManager::CameraManager() : pImpl(std::make_unique<Impl>()) {}
-CameraManager::~CameraManager() = default;
+        // Outputs still encoding were dropped with the encoder queues
+        {
+            std::lock_guard lock(groupMutex_);
+            pendingGroups_.clear();
+        }
 
-bool CameraManager::initialize(const CameraConfig& config) const {
-    return pImpl->initialize(config);
-}
+        requestsInFlight_ = 0;
+        for (auto& [stream, activity] : streamActivity_) {
+            activity.inFlight = 0;
+        }
 
-bool CameraManager::start(FrameCallback frameCallback, ErrorCallback errorCallback) const {
-    return pImpl->start(frameCallback, errorCallback);
-}
+        // Nothing will arrive for a start still waiting for its first frame
+        startMarkNs_ = 0;
+        { std::lock_guard lock(firstFrameMutex_); }
+        firstFrameCv_.notify_all();
+    }
 
-void CameraManager::stop() const {
-    pImpl->stop();
-}
+    void resetTimings() {
+        std::lock_guard lock(timingsMutex_);
+        timings_ = {};
+    }
 
-bool CameraManager::setControls(const Controls& controls) {
-    return pImpl->setControls(controls);
-}
+    /**
+     * Store the time since mark in a phase of timings_
+     * @return Now, the mark for the next phase
+     */
+    int64_t recordPhase(double LifecycleTimings::* phase, int64_t mark) {
+        const int64_t now = nowNs();
+        std::lock_guard lock(timingsMutex_);
+        timings_.*phase = static_cast<double>(now - mark) / 1e6;
+        return now;
+    }
 
-Controls CameraManager::getControls() const {
-    return pImpl->getControls();
-}
+    /**
+     * Start the thread that dispatches and requeues completed requests. The
+     * queue holds every completion that can be outstanding, since requests
+     * only return to libcamera once they went through it.
+     */
+    void startDispatcher() {
+        const size_t perRequest = streamManager_->streams().size() + 1;
+        completions_ = std::make_unique<SpscQueue<Completion>>(streamManager_->requests().size() * perRequest);
 
-ControlManager::Capabilities CameraManager::getCapabilities() const {
-    return pImpl->getCapabilities();
+        dispatching_ = true;
+        dispatcher_ = std::thread(&Impl::dispatchThread, this);
+    }
+
+    /**
+     * Stop the dispatch thread, completions still queued are dropped and
+     * their requests requeued by the next start
+     */
+    void stopDispatcher() {
+        if (!dispatcher_.joinable()) return;
+
+        dispatching_.store(false, std::memory_order_release);
+        completionSignal_.fetch_add(1, std::memory_order_release);
+        completionSignal_.notify_one();
+        dispatcher_.join();
+    }
+
+    void dispatchThread() {
+        Completion completion;
+
+        while (dispatching_.load(std::memory_order_acquire)) {
+            const uint32_t seen = completionSignal_.load(std::memory_order_acquire);
+
+            while (dispatching_.load(std::memory_order_relaxed) && completions_->pop(completion)) {
+                processCompletion(completion);
+            }
+
+            // Sleep until the completion thread posts again
+            completionSignal_.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * Start the thread that delivers groups at their deadline when no
+     * further request or output arrives, e.g. after the last frame before
+     * a pause or with a slow frame rate
+     */
+    void startGroupTimer() {
+        if (!grouped_) return;
+
+        groupTimerRunning_ = true;
+        groupTimer_ = std::thread(&Impl::groupTimerThread, this);
+    }
+
+    void stopGroupTimer() {
+        if (!groupTimer_.joinable()) return;
+
+        {
+            std::lock_guard lock(groupTimerMutex_);
+            groupTimerRunning_ = false;
+        }
+        groupTimerCv_.notify_all();
+        groupTimer_.join();
+    }
+
+    /**
+     * Sleep until the oldest pending group's deadline, or a full deadline
+     * while none is pending. openGroup() wakes the thread when the first
+     * group opens.
+     */
+    void groupTimerThread() {
+        std::unique_lock lock(groupTimerMutex_);
+
+        while (groupTimerRunning_) {
+            std::vector<FrameGroup> expired;
+            int64_t waitNs = groupDeadlineNs_;
+            {
+                std::lock_guard groups(groupMutex_);
+                const int64_t now = nowNs();
+                takeExpiredGroups(now, expired);
+                for (const auto& [sequence, pending] : pendingGroups_) {
+                    waitNs = std::min(waitNs, pending.openedNs + groupDeadlineNs_ - now);
+                }
+            }
+
+            if (!expired.empty()) {
+                lock.unlock();
+                for (const auto& group : expired) deliverGroup(group);
+                lock.lock();
+                continue;
+            }
+
+            groupTimerCv_.wait_for(lock, std::chrono::nanoseconds(std::max<int64_t>(waitNs, 1000000)),
+                                   [this] { return !groupTimerRunning_ || groupOpened_; });
+            groupOpened_ = false;
+        }
+    }
+
+    void startStillThread() {
+        if (!stillEncoder_) return;
+
+        stillsRunning_ = true;
+        stillThread_ = std::thread(&Impl::stillThread, this);
+    }
+
+    /**
+     * Stop the still thread before the camera stops, so no still request
+     * is requeued after it. Stills not encoded yet are dropped.
+     */
+    void stopStillThread() {
+        if (!stillThread_.joinable()) return;
+
+        stillEncoder_->stop();  // Later encode() calls return right away
+        {
+            std::lock_guard lock(zslMutex_);
+            stillsRunning_ = false;
+        }
+        stillCv_.notify_one();
+        stillThread_.join();
+    }
+
+    /**
+     * Copy checked out stills into the still encoder and requeue their
+     * requests, which may wait for the encoder queue without holding up
+     * the caller of captureStill() or the dispatch thread
+     */
+    void stillThread() {
+        std::unique_lock lock(zslMutex_);
+
+        while (true) {
+            stillCv_.wait(lock, [this] { return !stillQueue_.empty() || !stillsRunning_; });
+            if (stillQueue_.empty()) return;
+
+            const HeldRequest held = stillQueue_.front();
+            stillQueue_.pop_front();
+            lock.unlock();
+
+            const auto* info = streamManager_->getStreamInfo(zslStream_);
+            const uint8_t* data = streamManager_->getMappedData(held.buffer);
+            if (data && info) {
+                // The encoder copies the YUV data before returning
+                stillEncoder_->encode(
+                    data,
+                    info->width,
+                    info->height,
+                    info->stride,
+                    stillQuality_,
+                    Frame{{}, held.timestamp, held.sequence, nullptr, info->id, held.metadata},
+                    [this](StreamType, const Frame& frame) {
+                        stillsCaptured_.fetch_add(1, std::memory_order_relaxed);
+                        deliver(StreamType::STILL, frame);
+                    }
+                );
+            }
+
+            // Pending controls are left to the dispatch thread, the only one
+            // that applies them while streaming
+            requeue(held.request, false);
+            lock.lock();
+        }
+    }
+
+    /**
+     * Hand a completion to the dispatch thread without blocking or allocating
+     */
+    void post(const Completion& completion) {
+        // Sized for every outstanding completion, this only spins if the
+        // dispatcher is already being stopped
+        while (!completions_->push(completion)) {
+            if (!dispatching_.load(std::memory_order_relaxed)) return;
+            std::this_thread::yield();
+        }
+
+        completionSignal_.fetch_add(1, std::memory_order_release);
+        completionSignal_.notify_one();
+    }
+
+    void recordCallbackTime(int64_t enteredNs) {
+        const int64_t elapsed = nowNs() - enteredNs;
+        callbackNsTotal_.fetch_add(elapsed, std::memory_order_relaxed);
+        callbacks_.fetch_add(1, std::memory_order_relaxed);
+
+        int64_t max = callbackNsMax_.load(std::memory_order_relaxed);
+        while (elapsed > max && !callbackNsMax_.compare_exchange_weak(max, elapsed, std::memory_order_relaxed)) {}
+    }
+
+    void disconnectSignals() {
+        camera_->requestCompleted.disconnect(this, &Impl::requestComplete);
+        if (earlyDelivery_) {
+            camera_->bufferCompleted.disconnect(this, &Impl::bufferComplete);
+        }
+    }
+
+    /**
+     * Record start-up and blackout time on the first frame after a start
+     */
+    void markFirstFrame() {
+        const int64_t startMark = startMarkNs_.exchange(0, std::memory_order_relaxed);
+        if (!startMark) return;
+
+        const int64_t now = recordPhase(&LifecycleTimings::firstFrameMs, startMark);
+        lastStartMs_ = static_cast<double>(now - startMark) / 1e6;
+        { std::lock_guard lock(firstFrameMutex_); }
+        firstFrameCv_.notify_all();
+
+        if (const int64_t blackoutMark = blackoutMarkNs_.exchange(0, std::memory_order_relaxed)) {
+            lastBlackoutMs_ = static_cast<double>(now - blackoutMark) / 1e6;
+        }
+
+        if (const int64_t recoveryMark = recoveryMarkNs_.exchange(0, std::memory_order_relaxed)) {
+            lastRecoveryMs_ = static_cast<double>(now - recoveryMark) / 1e6;
+            recoveries_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void startWatchdog() {
+        if (!stallTimeoutMs_ || watchdog_.joinable()) return;
+
+        watchdogRunning_ = true;
+        watchdog_ = std::thread(&Impl::watchdogThread, this);
+    }
+
+    void stopWatchdog() {
+        {
+            std::lock_guard lock(watchdogMutex_);
+            watchdogRunning_ = false;
+        }
+        watchdogCv_.notify_all();
+        if (watchdog_.joinable()) watchdog_.join();
+    }
+
+    /**
+     * Poll a few times per stall threshold so a stall is reported at most
+     * a quarter threshold late
+     */
+    void watchdogThread() {
+        std::unique_lock lock(watchdogMutex_);
+
+        while (watchdogRunning_) {
+            const uint32_t timeoutMs = stallTimeoutMs_;
+            const auto interval = std::chrono::milliseconds(timeoutMs ? std::max<uint32_t>(timeoutMs / 4, 10) : 250);
+            watchdogCv_.wait_for(lock, interval, [this] { return !watchdogRunning_; });
+            if (!watchdogRunning_) break;
+
+            lock.unlock();
+            checkStall();
+            lock.lock();
+        }
+    }
+
+    /**
+     * Report a stall when a stream with buffers in flight completed none, or
+     * a JPEG frame sat in its encoder queue, for longer than the threshold
+     */
+    void checkStall() {
+        // Skip this round while start, stop or reconfigure is in progress
+        std::unique_lock lifecycle(lifecycleMutex_, std::try_to_lock);
+        if (!lifecycle.owns_lock()) return;
+
+        const uint32_t timeoutMs = stallTimeoutMs_;
+        if (!timeoutMs || !running_ || paused_) return;
+
+        const int64_t now = nowNs();
+
+        // A stream without buffers in flight waits for nothing
+        std::ostringstream streams;
+        double idleMs = 0;
+        const StreamManager::StreamInfo* idleStream = nullptr;
+        for (const auto& [stream, activity] : streamActivity_) {
+            const auto* info = streamManager_->getStreamInfo(stream);
+            const int64_t inFlight = activity.inFlight.load(std::memory_order_relaxed);
+            const double sinceMs = static_cast<double>(now - activity.lastCompletionNs.load(std::memory_order_relaxed)) / 1e6;
+            streams << ", " << streamName(*info) << ": " << inFlight << " in flight, last completed "
+                    << static_cast<int64_t>(sinceMs) << " ms ago";
+            if (inFlight > 0 && sinceMs > idleMs) {
+                idleMs = sinceMs;
+                idleStream = info;
+            }
+        }
+
+        std::ostringstream encoders;
+        double oldestMs = 0;
+        const StreamManager::StreamInfo* encoderStream = nullptr;
+        for (const auto& [stream, jpeg] : jpegStreams_) {
+            const auto* info = streamManager_->getStreamInfo(stream);
+            const double ageMs = jpeg->encoder.oldestQueuedMs();
+            if (ageMs > oldestMs) {
+                oldestMs = ageMs;
+                encoderStream = info;
+            }
+            encoders << ", " << streamName(*info) << " encoder: "
+                     << jpeg->encoder.queueDepth() << " queued, oldest " << static_cast<int64_t>(ageMs) << " ms";
+        }
+
+        const double stalledMs = std::max(idleMs, oldestMs);
+        if (stalledMs < timeoutMs) return;
+
+        stalls_.fetch_add(1, std::memory_order_relaxed);
+
+        std::ostringstream message;
+        const StreamManager::StreamInfo* stalled = idleMs >= oldestMs ? idleStream : encoderStream;
+        if (stalled == idleStream) {
+            message << "Pipeline stalled: no " << streamName(*stalled) << " buffer completed for "
+                    << static_cast<int64_t>(idleMs) << " ms";
+        } else {
+            message << "Pipeline stalled: " << streamName(*stalled) << " frame waiting for the encoder for "
+                    << static_cast<int64_t>(oldestMs) << " ms";
+        }
+        message << ", " << requestsInFlight_.load() << " requests in flight" << streams.str() << encoders.str();
+
+        const bool recover = autoRecover_;
+        errorCallback_({ErrorCode::Stalled, message.str(), stalledMs, recover, static_cast<int64_t>(stalled->id)});
+
+        if (!recover) {
+            // Report again only if the stall persists for another threshold
+            for (auto& [stream, activity] : streamActivity_) {
+                activity.lastCompletionNs = now;
+            }
+            return;
+        }
+
+        recoverPipeline(now);
+    }
+
+    static std::string streamName(const StreamManager::StreamInfo& info) {
+        switch (info.type) {
+            case StreamType::JPEG: return "jpeg stream " + std::to_string(info.id);
+            case StreamType::RGB: return "rgb stream " + std::to_string(info.id);
+            case StreamType::STILL: return "still stream";
+            case StreamType::RAW: break;
+        }
+        return "raw stream";
+    }
+
+    /**
+     * Stop, reallocate and restart capture with the current configuration
+     */
+    void recoverPipeline(int64_t mark) {
+        stopStreaming();
+
+        // Fresh buffers in case the stall left some of them owned by the driver
+        streamManager_->freeBuffers();
+        buffersAllocated_ = false;
+
+        recoveryMarkNs_ = mark;
+        startMarkNs_ = nowNs();
+        if (!startStreaming()) {
+            recoveryMarkNs_ = 0;
+            errorCallback_({ErrorCode::RecoveryFailed, "Failed to restart the camera after a stall."});
+        }
+    }
+
+    /**
+     * Record time to the first frame after resume()
+     */
+    void markResumed() {
+        const int64_t resumeMark = resumeMarkNs_.exchange(0, std::memory_order_relaxed);
+        if (!resumeMark) return;
+
+        lastResumeMs_ = static_cast<double>(nowNs() - resumeMark) / 1e6;
+        resumes_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Called by libcamera when a capture request completes. Runs on the
+     * pipeline handler thread, so only bookkeeping happens here and the
+     * request is handed to the dispatch thread.
+     */
+    void requestComplete(lc::Request* request) {
+        const int64_t entered = nowNs();
+
+        requestsInFlight_.fetch_sub(1, std::memory_order_relaxed);
+        const bool cancelled = request->status() == lc::Request::RequestCancelled;
+
+        // A stream whose buffers keep failing stalls even while requests complete
+        for (const auto& [stream, buffer] : request->buffers()) {
+            const auto it = streamActivity_.find(stream);
+            if (it == streamActivity_.end()) continue;
+
+            it->second.inFlight.fetch_sub(1, std::memory_order_relaxed);
+            if (!cancelled && buffer->metadata().status == lc::FrameMetadata::FrameSuccess) {
+                it->second.lastCompletionNs.store(entered, std::memory_order_relaxed);
+            }
+        }
+        if (cancelled) return;
+
+        requestsCompleted_.fetch_add(1, std::memory_order_relaxed);
+        if (startMarkNs_.load(std::memory_order_relaxed)) markFirstFrame();
+        if (resumeMarkNs_.load(std::memory_order_relaxed)) markResumed();
+
+        // Extract frame metadata
+        uint32_t sequence = request->sequence();
+        uint64_t timestamp = request->metadata().get(lc::controls::SensorTimestamp)
+                                              .value_or(0);
+
+        post({request, nullptr, timestamp, sequence});
+        recordCallbackTime(entered);
+    }
+
+    /**
+     * Dispatch a completion on the dispatch thread: deliver or encode its
+     * buffers, then requeue the request
+     */
+    void processCompletion(const Completion& completion) {
+        if (completion.buffer) {
+            // Request metadata is not complete yet, early buffers carry none
+            for (auto& [stream, candidate] : completion.request->buffers()) {
+                if (candidate != completion.buffer) continue;
+                dispatchBuffer(stream, completion.buffer, completion.timestamp, completion.sequence, {});
+                break;
+            }
+            return;
+        }
+
+        auto* request = completion.request;
+        FrameMetadata metadata = readMetadata(request->metadata());
+        metadata.values[FrameMetadata::ControlTag] = requestTags_[request->cookie()];
+        trackFrameRate(metadata[FrameMetadata::FrameDuration]);
+        if (grouped_) openGroup(request, completion.timestamp, completion.sequence, metadata);
+
+        // Buffers were already dispatched one by one in early delivery mode
+        if (!earlyDelivery_) {
+            // Process each stream in the request
+            for (auto& [stream, buffer] : request->buffers()) {
+                dispatchBuffer(stream, buffer, completion.timestamp, completion.sequence, metadata);
+            }
+        }
+
+        // Keep the request in the zero-shutter-lag ring and recycle the
+        // oldest one held there instead
+        if (zslStream_) {
+            request = holdForStill(request, completion.timestamp, completion.sequence, metadata);
+            if (!request) return;
+        }
+
+        requeue(request);
+    }
+
+    /**
+     * Smooth the frame rate the sensor reports through FrameDuration, which
+     * follows the AE within a frame duration range
+     */
+    void trackFrameRate(double durationUs) {
+        if (!(durationUs > 0)) return;
+
+        const double fps = 1e6 / durationUs;
+        const double previous = achievedFps_.load(std::memory_order_relaxed);
+        achievedFps_.store(previous ? previous + (fps - previous) / 8 : fps, std::memory_order_relaxed);
+    }
+
+    /**
+     * Reset a request, attach pending controls and queue it again. While
+     * paused, the request is parked with its buffers for resume().
+     */
+    void requeue(lc::Request* request, bool applyPending = true) {
+        // reuse() clears the control list, so controls are attached afterwards
+        request->reuse(lc::Request::ReuseBuffers);
+
+        uint32_t tag = 0;
+        if (applyPending) {
+            // Apply any pending control changes, a single load when there are none
+            if (pendingControls_.load(std::memory_order_relaxed)) {
+                std::unique_ptr<Controls> pending{pendingControls_.exchange(nullptr, std::memory_order_acquire)};
+                if (pending) controlManager_->applyControls(*pending, request);
+            }
+
+            tag = applyScheduled(request);
+            applyCrop(request);
+        }
+        requestTags_[request->cookie()] = tag;
+
+        if (paused_.load(std::memory_order_relaxed)) {
+            std::lock_guard lock(parkMutex_);
+            if (paused_) {
+                parked_.push_back(request);
+                return;
+            }
+        }
+
+        requestsInFlight_.fetch_add(1, std::memory_order_relaxed);
+        countQueued(request);
+        camera_->queueRequest(request);
+    }
+
+    /**
+     * Count the buffers of a request about to be queued against their streams
+     */
+    void countQueued(lc::Request* request) {
+        for (const auto& [stream, buffer] : request->buffers()) {
+            const auto it = streamActivity_.find(stream);
+            if (it != streamActivity_.end()) it->second.inFlight.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Attach the bracket step and any controls scheduled for this position
+     * in the queue order. Scheduled controls win over the bracket.
+     * @return Control tag of the request, 0 if none
+     */
+    uint32_t applyScheduled(lc::Request* request) {
+        const uint64_t index = queueIndex_.fetch_add(1, std::memory_order_acq_rel);
+        uint32_t tag = 0;
+
+        // Pick up a bracket replaced by setBracket()
+        if (bracketChanged_.load(std::memory_order_relaxed) && bracketChanged_.exchange(false, std::memory_order_acquire)) {
+            activeBracket_ = bracket_.load(std::memory_order_acquire);
+            bracketStep_ = 0;
+        }
+
+        if (activeBracket_) {
+            const size_t step = bracketStep_++ % activeBracket_->sets.size();
+            controlManager_->applyControls(activeBracket_->sets[step], request);
+            tag = activeBracket_->tags[step];
+        }
+
+        if (!hasSchedule_.load(std::memory_order_acquire)) return tag;
+
+        std::lock_guard lock(scheduleMutex_);
+
+        // Entries behind the queue position were scheduled too late, apply
+        // them now rather than dropping them
+        for (auto it = schedule_.begin(); it != schedule_.end() && it->first <= index;) {
+            controlManager_->applyControls(it->second.controls, request);
+            tag = it->second.tag;
+            it = schedule_.erase(it);
+        }
+        hasSchedule_.store(!schedule_.empty(), std::memory_order_release);
+
+        return tag;
+    }
+
+    /**
+     * Advance the crop one step towards the region set by setCrop()
+     */
+    void applyCrop(lc::Request* request) {
+        if (cropChanged_.load(std::memory_order_relaxed) && cropChanged_.exchange(false, std::memory_order_acquire)) {
+            // A new target mid-transition starts from where the crop is now
+            const auto target = cropTarget_.load(std::memory_order_acquire);
+            cropFrom_ = cropCurrent_;
+            cropTo_ = target->region;
+            cropSteps_ = std::max<uint32_t>(target->frames, 1);
+            cropStep_ = 0;
+        }
+
+        if (cropStep_ >= cropSteps_) return;
+
+        // Smoothstep, so pans start and stop without a jolt
+        const double t = static_cast<double>(++cropStep_) / cropSteps_;
+        const double eased = t * t * (3 - 2 * t);
+        auto lerp = [eased](double from, double to) { return from + (to - from) * eased; };
+
+        cropCurrent_ = {lerp(cropFrom_.x, cropTo_.x), lerp(cropFrom_.y, cropTo_.y),
+                        lerp(cropFrom_.width, cropTo_.width), lerp(cropFrom_.height, cropTo_.height)};
+        request->controls().set(lc::controls::ScalerCrop, toSensorCrop(cropCurrent_));
+    }
+
+    /**
+     * Push a completed request into the ZSL ring
+     * @return Request evicted from the ring to requeue, nullptr if none
+     */
+    lc::Request* holdForStill(lc::Request* request, uint64_t timestamp, uint32_t sequence,
+                              const FrameMetadata& metadata) {
+        auto* buffer = request->findBuffer(zslStream_);
+        if (!buffer) return request;
+
+        std::lock_guard lock(zslMutex_);
+        zslRing_.push_back({request, buffer, timestamp, sequence, metadata});
+        if (zslRing_.size() <= zslDepth_) return nullptr;
+
+        auto* oldest = zslRing_.front().request;
+        zslRing_.pop_front();
+        return oldest;
+    }
+
+    /**
+     * Called by libcamera as soon as a single buffer of a request completes
+     * (early delivery mode only). The request is requeued once the whole
+     * request completed.
+     */
+    void bufferComplete(lc::Request* request, lc::FrameBuffer* buffer) {
+        const int64_t entered = nowNs();
+        if (buffer->metadata().status != lc::FrameMetadata::FrameSuccess) return;
+
+        // The sensor timestamp control is only filled in with the request
+        // metadata, so use the buffer's own capture timestamp here
+        post({request, buffer, buffer->metadata().timestamp, request->sequence()});
+        recordCallbackTime(entered);
+    }
+
+    /**
+     * Deliver an RGB buffer or queue a JPEG buffer for encoding
+     */
+    void dispatchBuffer(const lc::Stream* stream, lc::FrameBuffer* buffer,
+                        uint64_t timestamp, uint32_t sequence, const FrameMetadata& metadata) {
+        const auto* info = streamManager_->getStreamInfo(stream);
+
+        // RAW is not processed, STILL buffers are only encoded on request
+        if (!info || info->type == StreamType::RAW || info->type == StreamType::STILL) return;
+
+        const uint8_t* data = streamManager_->getMappedData(buffer);
+        size_t size = streamManager_->getMappedSize(buffer);
+
+        if (!data) return;
+
+        if (info->type == StreamType::RGB) {
+            // Direct delivery for RGB frames
+            Frame frame{
+                std::span(data, size),
+                timestamp,
+                sequence,
+                nullptr,
+                info->id,
+                metadata
+            };
+            if (grouped_) {
+                addToGroup(StreamType::RGB, frame);
+            } else {
+                deliver(StreamType::RGB, frame);
+            }
+            rgbFramesDelivered_.fetch_add(1, std::memory_order_relaxed);
+        } else if (info->type == StreamType::JPEG) {
+            // Queue for async JPEG encoding on this stream's own encoder
+            auto& jpeg = *jpegStreams_.at(stream);
+
+            // The buffer is requeued right away, so a skipped frame costs
+            // nothing but this check
+            if (!takeDemand(jpeg, false)) {
+                jpeg.framesSkipped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            jpeg.encoder.encode(
+                data,
+                info->width,
+                info->height,
+                info->stride,
+                jpeg.quality,
+                Frame{{}, timestamp, sequence, nullptr, info->id, metadata},
+                grouped_ ? groupMemberCallback_ : deliverCallback_
+            );
+        }
+    }
+
+    /**
+     * Hand a finished frame to the frame callback and any native listeners
+     */
+    void deliver(StreamType type, const Frame& frame) {
+        frameCallback_(type, frame);
+        notifyListeners(type, frame);
+    }
+
+    void notifyListeners(StreamType type, const Frame& frame) {
+        if (!hasListeners_.load(std::memory_order_acquire)) return;
+
+        std::lock_guard lock(listenerMutex_);
+        for (const auto& [id, listener] : listeners_) {
+            listener(type, frame);
+        }
+    }
+
+    /**
+     * Start collecting the RGB and JPEG outputs of a request
+     */
+    void openGroup(lc::Request* request, uint64_t timestamp, uint32_t sequence, const FrameMetadata& metadata) {
+        size_t members = 0;
+        for (const auto& [stream, buffer] : request->buffers()) {
+            const auto* info = streamManager_->getStreamInfo(stream);
+            if (!info) continue;
+
+            // Skipped on-demand frames would hold the group to its deadline
+            if (info->type == StreamType::RGB ||
+                (info->type == StreamType::JPEG && takeDemand(*jpegStreams_.at(stream), true))) {
+                members++;
+            }
+        }
+        if (!members) return;
+
+        const int64_t now = nowNs();
+        std::vector<FrameGroup> expired;
+        bool first = false;
+        {
+            std::lock_guard lock(groupMutex_);
+            takeExpiredGroups(now, expired);
+
+            first = pendingGroups_.empty();
+            auto& pending = pendingGroups_[sequence];
+            pending.group = FrameGroup{sequence, timestamp, metadata, {}, false};
+            pending.group.frames.reserve(members);
+            pending.outstanding = members;
+            pending.openedNs = now;
+        }
+
+        // The timer sleeps a full deadline while no group is pending
+        if (first) {
+            {
+                std::lock_guard lock(groupTimerMutex_);
+                groupOpened_ = true;
+            }
+            groupTimerCv_.notify_one();
+        }
+
+        for (const auto& group : expired) deliverGroup(group);
+    }
+
+    /**
+     * Add an RGB frame or finished JPEG to its request's group and deliver
+     * the group once every output arrived
+     */
+    void addToGroup(StreamType type, const Frame& frame) {
+        notifyListeners(type, frame);
+
+        // The RGB buffer is requeued before the JPEGs of its request finish
+        Frame member = frame;
+        if (type == StreamType::RGB && !jpegStreams_.empty()) {
+            auto copy = std::make_shared<std::vector<uint8_t>>(frame.data.begin(), frame.data.end());
+            member.data = std::span<const uint8_t>(copy->data(), copy->size());
+            member.owner = std::move(copy);
+        }
+
+        std::vector<FrameGroup> ready;
+        {
+            std::lock_guard lock(groupMutex_);
+            takeExpiredGroups(nowNs(), ready);
+
+            // Missing means the group already went out at its deadline
+            auto it = pendingGroups_.find(frame.sequence);
+            if (it != pendingGroups_.end()) {
+                auto& pending = it->second;
+                pending.group.frames.emplace_back(type, std::move(member));
+                if (--pending.outstanding == 0) {
+                    pending.group.complete = true;
+                    ready.push_back(std::move(pending.group));
+                    pendingGroups_.erase(it);
+                }
+            }
+        }
+
+        for (const auto& group : ready) deliverGroup(group);
+    }
+
+    /**
+     * Move groups past their deadline to out, oldest first. The deadline is
+     * checked whenever a request or output arrives, and by the group timer.
+     */
+    void takeExpiredGroups(int64_t now, std::vector<FrameGroup>& out) {
+        for (auto it = pendingGroups_.begin(); it != pendingGroups_.end();) {
+            if (now - it->second.openedNs < groupDeadlineNs_) {
+                ++it;
+                continue;
+            }
+
+            out.push_back(std::move(it->second.group));
+            it = pendingGroups_.erase(it);
+        }
+    }
+
+    void deliverGroup(FrameGroup group) {
+        std::sort(group.frames.begin(), group.frames.end(),
+                  [](const auto& a, const auto& b) { return a.second.streamId < b.second.streamId; });
+
+        groupsDelivered_.fetch_add(1, std::memory_order_relaxed);
+        if (!group.complete) groupsIncomplete_.fetch_add(1, std::memory_order_relaxed);
+
+        if (groupCallback_) groupCallback_(group);
+    }
+
+    std::shared_ptr<lc::CameraManager> lcManager_;  // Process-wide, shared by all instances
+    std::shared_ptr<lc::Camera> camera_;
+    /**
+     * Encoder and quality state owned by a single JPEG stream
+     */
+    struct JpegStream {
+        explicit JpegStream(size_t queueSize) : encoder(queueSize) {}
+
+        JpegEncoder encoder;
+        std::atomic<int> quality{85};
+        std::optional<int32_t> fixedQuality;  // Per-stream override from config
+        bool onDemand = false;
+        std::atomic<bool> demanded{false};   // requestFrame() since the last encode
+        bool groupDemand = false;            // Taken by openGroup() for this request, dispatch thread only
+        std::atomic<uint64_t> framesSkipped{0};
+    };
+
+    /**
+     * Whether an on-demand stream encodes this request's frame. Grouping
+     * decides in openGroup(), so the group counts exactly the outputs that
+     * will arrive; a later demand waits for the next request.
+     */
+    bool takeDemand(JpegStream& jpeg, bool forGroup) {
+        if (!jpeg.onDemand) return true;
+        if (forGroup) return jpeg.groupDemand = jpeg.demanded.exchange(false, std::memory_order_acq_rel);
+        if (grouped_) return std::exchange(jpeg.groupDemand, false);
+        return jpeg.demanded.exchange(false, std::memory_order_acq_rel);
+    }
+
+    /**
+     * Completed request kept back for zero-shutter-lag capture
+     */
+    struct HeldRequest {
+        lc::Request* request = nullptr;
+        lc::FrameBuffer* buffer = nullptr;  // Full resolution YUV buffer
+        uint64_t timestamp = 0;
+        uint32_t sequence = 0;
+        FrameMetadata metadata;
+    };
+
+    std::unique_ptr<StreamManager> streamManager_;
+    std::map<const lc::Stream*, std::unique_ptr<JpegStream>> jpegStreams_;
+
+    // Zero-shutter-lag ring of the most recent full resolution frames
+    const lc::Stream* zslStream_ = nullptr;
+    std::unique_ptr<JpegEncoder> stillEncoder_;
+    std::deque<HeldRequest> zslRing_;
+    std::deque<HeldRequest> stillQueue_;  // Checked out by captureStill() for the still thread
+    std::mutex zslMutex_;                 // Guards both queues and stillsRunning_
+    std::condition_variable stillCv_;
+    std::thread stillThread_;
+    bool stillsRunning_ = false;
+    size_t zslDepth_ = 0;
+    int stillQuality_ = 95;
+    std::atomic<uint64_t> stillsCaptured_{0};
+    std::unique_ptr<ControlManager> controlManager_;
+
+    FrameCallback frameCallback_;
+    FrameCallback deliverCallback_;  // Routes encoder output through deliver()
+    FrameCallback groupMemberCallback_;  // Routes encoder output through addToGroup()
+    GroupCallback groupCallback_;
+    ErrorCallback errorCallback_;
+
+    std::vector<std::pair<uint32_t, FrameCallback>> listeners_;
+    std::mutex listenerMutex_;
+    std::atomic<bool> hasListeners_{false};
+    uint32_t nextListenerId_ = 1;
+
+    Controls initialControls_;
+    std::atomic<Controls*> pendingControls_{nullptr};  // Owned, taken by the next requeued request
+    std::mutex controlMutex_;  // Between setControls() callers
+
+    /**
+     * Control sets cycled over consecutive requests
+     */
+    struct Bracket {
+        std::vector<Controls> sets;
+        std::vector<uint32_t> tags;
+    };
+
+    /**
+     * Controls attached to one future request
+     */
+    struct ScheduledControls {
+        Controls controls;
+        uint32_t tag = 0;
+    };
+
+    // Scheduled controls keyed by the queue position of their request
+    std::map<uint64_t, ScheduledControls> schedule_;
+    std::mutex scheduleMutex_;
+    std::atomic<bool> hasSchedule_{false};
+    std::atomic<uint64_t> queueIndex_{0};  // Requests requeued by the dispatch thread
+    uint32_t nextControlTag_ = 1;
+    std::atomic<std::shared_ptr<const Bracket>> bracket_;
+    std::atomic<bool> bracketChanged_{false};
+    std::shared_ptr<const Bracket> activeBracket_;  // Dispatch thread only
+    size_t bracketStep_ = 0;
+    std::vector<uint32_t> requestTags_;  // Control tag per request, indexed by cookie
+
+    /**
+     * Crop region requested by setCrop()
+     */
+    struct CropTransition {
+        CropRegion region;
+        uint32_t frames = 0;
+    };
+
+    // ISP zoom, stepped by the dispatch thread
+    std::atomic<std::shared_ptr<const CropTransition>> cropTarget_;
+    std::atomic<bool> cropChanged_{false};
+    lc::Rectangle cropMaximum_;  // Only written while the dispatcher is stopped
+    std::atomic<bool> cropSupported_{false};
+    CropRegion cropFrom_;
+    CropRegion cropTo_;
+    CropRegion cropCurrent_;  // Last crop written to a request
+    uint32_t cropStep_ = 0;
+    uint32_t cropSteps_ = 0;
+
+    std::atomic<uint64_t> requestsCompleted_{0};
+    std::atomic<double> achievedFps_{0};  // Written by the dispatch thread only
+    std::atomic<uint64_t> rgbFramesDelivered_{0};
+    std::atomic<uint64_t> reconfigures_{0};
+
+    // Timing marks awaiting the first frame, 0 when nothing is pending
+    std::atomic<int64_t> startMarkNs_{0};
+    std::atomic<int64_t> blackoutMarkNs_{0};
+    std::atomic<double> lastStartMs_{0};
+    std::atomic<double> lastBlackoutMs_{0};
+
+    LifecycleTimings timings_;
+    std::mutex timingsMutex_;
+    std::mutex firstFrameMutex_;  // Pairs with firstFrameCv_, startMarkNs_ is the condition
+    std::condition_variable firstFrameCv_;
+
+    std::atomic<int64_t> resumeMarkNs_{0};
+    std::atomic<double> lastResumeMs_{0};
+    std::atomic<uint64_t> resumes_{0};
+
+    // Requests held back while paused, buffers stay allocated and mapped
+    std::vector<lc::Request*> parked_;
+    std::mutex parkMutex_;
+    std::atomic<bool> paused_{false};
+
+    /**
+     * Group waiting for outputs that are still being encoded
+     */
+    struct PendingGroup {
+        FrameGroup group;
+        size_t outstanding = 0;
+        int64_t openedNs = 0;
+    };
+
+    // Grouped delivery, keyed by request sequence
+    std::map<uint32_t, PendingGroup> pendingGroups_;
+    std::mutex groupMutex_;
+    bool grouped_ = false;
+    int64_t groupDeadlineNs_ = 0;
+    std::atomic<uint64_t> groupsDelivered_{0};
+    std::atomic<uint64_t> groupsIncomplete_{0};
+
+    // Delivers groups at their deadline, runs while streaming with grouped delivery
+    std::thread groupTimer_;
+    std::mutex groupTimerMutex_;
+    std::condition_variable groupTimerCv_;
+    bool groupTimerRunning_ = false;
+    bool groupOpened_ = false;
+
+    // Dispatch thread fed from libcamera's completion thread
+    std::unique_ptr<SpscQueue<Completion>> completions_;
+    std::thread dispatcher_;
+    std::atomic<bool> dispatching_{false};
+    std::atomic<uint32_t> completionSignal_{0};
+    std::atomic<int64_t> callbackNsTotal_{0};
+    std::atomic<int64_t> callbackNsMax_{0};
+    std::atomic<uint64_t> callbacks_{0};
+
+    // Stall watchdog, started with the first start() that has a threshold
+    std::thread watchdog_;
+    std::mutex watchdogMutex_;
+    std::condition_variable watchdogCv_;
+    bool watchdogRunning_ = false;
+    std::atomic<uint32_t> stallTimeoutMs_{0};
+    std::atomic<bool> autoRecover_{false};
+    std::atomic<int64_t> requestsInFlight_{0};
+    struct StreamActivity {
+        std::atomic<int64_t> inFlight{0};          // Buffers queued to libcamera
+        std::atomic<int64_t> lastCompletionNs{0};  // Last buffer completed with data
+    };
+    std::map<const lc::Stream*, StreamActivity> streamActivity_;  // Rebuilt by each start
+    std::atomic<uint64_t> stalls_{0};
+    std::atomic<uint64_t> recoveries_{0};
+    std::atomic<int64_t> recoveryMarkNs_{0};
+    std::atomic<double> lastRecoveryMs_{0};
+    std::mutex lifecycleMutex_;  // Serialises start, stop, reconfigure and recovery
+
+    CameraConfig config_;  // Active configuration, compared on reconfigure
+    bool buffersAllocated_ = false;
+
+    std::string cameraId_;
+    bool earlyDelivery_ = false;
+    bool acquired_ = false;
+    std::atomic<bool> running_{false};
+    std::string lastError_;
+};
+
+// Public interface implementation
+CameraManager::CameraManager() : pImpl(std::make_unique<Impl>()) {}
+CameraManager::~CameraManager() = default;
+
+bool CameraManager::initialize(const CameraConfig& config) const {
+    return pImpl->initialize(config);
+}
+
+bool CameraManager::start(FrameCallback frameCallback, ErrorCallback errorCallback,
+                          GroupCallback groupCallback) const {
+    return pImpl->start(frameCallback, errorCallback, groupCallback);
+}
+
+void CameraManager::stop() const {
+    pImpl->stop();
+}
+
+bool CameraManager::pause() const {
+    return pImpl->pause();
+}
+
+bool CameraManager::resume() const {
+    return pImpl->resume();
+}
+
+bool CameraManager::captureStill(uint64_t at) const {
+    return pImpl->captureStill(at);
+}
+
+bool CameraManager::reconfigure(const CameraConfig& config) const {
+    return pImpl->reconfigure(config);
+}
+
+bool CameraManager::setControls(const Controls& controls) {
+    return pImpl->setControls(controls);
+}
+
+uint32_t CameraManager::scheduleControls(const Controls& controls, uint32_t framesAhead) {
+    return pImpl->scheduleControls(controls, framesAhead);
+}
+
+std::vector<uint32_t> CameraManager::setBracket(const std::vector<Controls>& sets) {
+    return pImpl->setBracket(sets);
+}
+
+bool CameraManager::setCrop(const CropRegion& region, uint32_t transitionFrames) {
+    return pImpl->setCrop(region, transitionFrames);
+}
+
+bool CameraManager::requestFrame(uint32_t streamId) {
+    return pImpl->requestFrame(streamId);
+}
+
+Controls CameraManager::getControls() const {
+    return pImpl->getControls();
+}
+
+ControlManager::Capabilities CameraManager::getCapabilities() const {
+    return pImpl->getCapabilities();
+}
+
+uint32_t CameraManager::addFrameListener(FrameCallback listener) {
+    return pImpl->addFrameListener(std::move(listener));
+}
+
+void CameraManager::removeFrameListener(uint32_t id) {
+    pImpl->removeFrameListener(id);
+}
+
+bool CameraManager::isRunning() const {
+    return pImpl->isRunning();
+}
+
+CameraStats CameraManager::getStats() const {
+    return pImpl->getStats();
+}
+
+LifecycleTimings CameraManager::getTimings() const {
+    return pImpl->getTimings();
+}
+
+bool CameraManager::waitForFirstFrame(uint32_t timeoutMs) const {
+    return pImpl->waitForFirstFrame(timeoutMs);
+}
+
+std::string CameraManager::lastError() const {
+    return pImpl->lastError();
+}
+
+std::optional<StreamLayout> CameraManager::getStreamLayout(uint32_t streamId) const {
+    return pImpl->getStreamLayout(streamId);
 }
 
 }
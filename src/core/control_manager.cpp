@@ -1,112 +1,212 @@
 #include <utility>
+#include <chrono>
+#include <iostream>
+#include <cctype>
+#include <cmath>
 #include "control_manager.hpp"
 
 namespace lcam {
 
 ControlManager::ControlManager(std::shared_ptr<lc::Camera> camera)
-    : camera_(std::move(camera)) {}
+    : camera_(std::move(camera)), table_(camera_->controls()) {}
 
-void ControlManager::applyControls(const Controls& controls, lc::Request* request) {
-    std::lock_guard lock(mutex_);
-
-    // Merge new controls with pending ones using helper template
-    assignIfSet(pendingControls_.exposureMode, controls.exposureMode);
-    assignIfSet(pendingControls_.exposureTime, controls.exposureTime);
-    assignIfSet(pendingControls_.analogueGain, controls.analogueGain);
-    assignIfSet(pendingControls_.afMode, controls.afMode);
-    assignIfSet(pendingControls_.afTrigger, controls.afTrigger);
-    assignIfSet(pendingControls_.lensPosition, controls.lensPosition);
-    assignIfSet(pendingControls_.awbMode, controls.awbMode);
-    assignIfSet(pendingControls_.colourGains, controls.colourGains);
-    assignIfSet(pendingControls_.brightness, controls.brightness);
-    assignIfSet(pendingControls_.contrast, controls.contrast);
-    assignIfSet(pendingControls_.saturation, controls.saturation);
-    assignIfSet(pendingControls_.sharpness, controls.sharpness);
-    assignIfSet(pendingControls_.targetFps, controls.targetFps);
-    assignIfSet(pendingControls_.jpegQuality, controls.jpegQuality);
-
-    // Apply controls to the request
-    auto& reqControls = request->controls();
+std::vector<ControlSetting> ControlManager::resolve(const std::vector<ControlSetting>& settings) const {
+    std::vector<ControlSetting> resolved;
+    resolved.reserve(settings.size());
 
-    if (pendingControls_.exposureMode) {
-        reqControls.set(lc::controls::AeExposureMode, *pendingControls_.exposureMode);
-        currentControls_.exposureMode = pendingControls_.exposureMode;
-    }
+    for (const auto& setting : settings) {
+        const auto* entry = table_.find(setting);
+        if (!entry) {
+            std::cerr << "Camera does not support control "
+                      << (setting.id ? std::to_string(setting.id) : setting.name) << std::endl;
+            continue;
+        }
 
-    if (pendingControls_.exposureTime) {
-        reqControls.set(lc::controls::ExposureTime, *pendingControls_.exposureTime);
-        currentControls_.exposureTime = pendingControls_.exposureTime;
+        resolved.push_back({entry->id, entry->name, setting.values});
     }
 
-    if (pendingControls_.analogueGain) {
-        reqControls.set(lc::controls::AnalogueGain, *pendingControls_.analogueGain);
-        currentControls_.analogueGain = pendingControls_.analogueGain;
-    }
+    return resolved;
+}
 
-    if (pendingControls_.afMode) {
-        reqControls.set(lc::controls::AfMode, *pendingControls_.afMode);
-        currentControls_.afMode = pendingControls_.afMode;
+void ControlManager::applyControls(const Controls& controls, lc::Request* request) {
+    // Merge new controls with pending ones, generic ones keyed by their id
+    if (controls.extra.empty()) {
+        mergeControls(pendingControls_, controls);
+    } else {
+        Controls resolved = controls;
+        resolved.extra = resolve(controls.extra);
+        mergeControls(pendingControls_, resolved);
     }
 
+    // Write only what differs from the state already committed to the
+    // pipeline, libcamera keeps controls until they are set again
+    const auto begin = std::chrono::steady_clock::now();
+    auto& reqControls = request->controls();
+    size_t written = 0;
+
+    const bool fullWrite = fullWrite_.exchange(false, std::memory_order_acq_rel) ||
+                           writeAll_.load(std::memory_order_relaxed);
+
+    auto commit = [fullWrite, &written](const auto& desired, auto& committed, auto&& write) {
+        if (!desired || (!fullWrite && desired == committed)) return;
+        write(*desired);
+        committed = desired;
+        written++;
+    };
+
+    commit(pendingControls_.exposureMode, currentControls_.exposureMode, [&](int32_t mode) {
+        reqControls.set(lc::controls::AeExposureMode, mode);
+    });
+
+    commit(pendingControls_.exposureTime, currentControls_.exposureTime, [&](int32_t time) {
+        reqControls.set(lc::controls::ExposureTime, time);
+    });
+
+    commit(pendingControls_.analogueGain, currentControls_.analogueGain, [&](float gain) {
+        reqControls.set(lc::controls::AnalogueGain, gain);
+    });
+
+    commit(pendingControls_.afMode, currentControls_.afMode, [&](int32_t mode) {
+        reqControls.set(lc::controls::AfMode, mode);
+    });
+
     if (pendingControls_.afTrigger) {
         reqControls.set(lc::controls::AfTrigger, *pendingControls_.afTrigger);
         pendingControls_.afTrigger.reset();  // One-shot control
+        written++;
     }
 
-    if (pendingControls_.lensPosition) {
-        reqControls.set(lc::controls::LensPosition, *pendingControls_.lensPosition);
-        currentControls_.lensPosition = pendingControls_.lensPosition;
-    }
+    commit(pendingControls_.lensPosition, currentControls_.lensPosition, [&](float position) {
+        reqControls.set(lc::controls::LensPosition, position);
+    });
 
-    if (pendingControls_.awbMode) {
-        reqControls.set(lc::controls::AwbMode, *pendingControls_.awbMode);
-        currentControls_.awbMode = pendingControls_.awbMode;
-    }
+    commit(pendingControls_.awbMode, currentControls_.awbMode, [&](int32_t mode) {
+        reqControls.set(lc::controls::AwbMode, mode);
+    });
 
-    if (pendingControls_.colourGains && pendingControls_.colourGains->size() >= 2) {
-        std::array<float, 2> gains = *pendingControls_.colourGains;
+    commit(pendingControls_.colourGains, currentControls_.colourGains, [&](std::array<float, 2> gains) {
         reqControls.set(lc::controls::ColourGains, lc::Span<const float, 2>(gains.data(), 2));
-        currentControls_.colourGains = pendingControls_.colourGains;
-    }
+    });
 
-    if (pendingControls_.brightness) {
-        reqControls.set(lc::controls::Brightness, *pendingControls_.brightness);
-        currentControls_.brightness = pendingControls_.brightness;
-    }
+    commit(pendingControls_.brightness, currentControls_.brightness, [&](float value) {
+        reqControls.set(lc::controls::Brightness, value);
+    });
 
-    if (pendingControls_.contrast) {
-        reqControls.set(lc::controls::Contrast, *pendingControls_.contrast);
-        currentControls_.contrast = pendingControls_.contrast;
-    }
+    commit(pendingControls_.contrast, currentControls_.contrast, [&](float value) {
+        reqControls.set(lc::controls::Contrast, value);
+    });
 
-    if (pendingControls_.saturation) {
-        reqControls.set(lc::controls::Saturation, *pendingControls_.saturation);
-        currentControls_.saturation = pendingControls_.saturation;
-    }
+    commit(pendingControls_.saturation, currentControls_.saturation, [&](float value) {
+        reqControls.set(lc::controls::Saturation, value);
+    });
 
-    if (pendingControls_.sharpness) {
-        reqControls.set(lc::controls::Sharpness, *pendingControls_.sharpness);
-        currentControls_.sharpness = pendingControls_.sharpness;
-    }
+    commit(pendingControls_.sharpness, currentControls_.sharpness, [&](float value) {
+        reqControls.set(lc::controls::Sharpness, value);
+    });
 
-    if (pendingControls_.targetFps) {
-        // Convert FPS to frame duration in microseconds
-        const auto duration = 1000000 / *pendingControls_.targetFps;
-        std::array<int64_t, 2> limits = {duration, duration};
+    // The frame rate fields all end up in FrameDurationLimits
+    const auto limits = frameDurationLimits(pendingControls_);
+    commit(limits, committedLimits_, [&](std::array<int64_t, 2> durations) {
         reqControls.set(lc::controls::FrameDurationLimits,
-                       lc::Span<const int64_t, 2>(limits.data(), 2));
-        currentControls_.targetFps = pendingControls_.targetFps;
+                       lc::Span<const int64_t, 2>(durations.data(), 2));
+    });
+    currentControls_.targetFps = pendingControls_.targetFps;
+    currentControls_.minFps = pendingControls_.minFps;
+    currentControls_.maxFps = pendingControls_.maxFps;
+    currentControls_.maxThroughput = pendingControls_.maxThroughput;
+
+    // Generic controls, converted to the control's type only when changed
+    for (const auto& setting : pendingControls_.extra) {
+        auto committed = std::find_if(currentControls_.extra.begin(), currentControls_.extra.end(),
+                                      [&](const auto& existing) { return existing.id == setting.id; });
+        if (!fullWrite && committed != currentControls_.extra.end() && committed->values == setting.values) continue;
+
+        const auto* entry = table_.find(setting.id);
+        const auto value = ControlTable::toValue(*entry, setting.values);
+        if (value.isNone()) {
+            std::cerr << "Invalid value for control " << setting.name << std::endl;
+            continue;
+        }
+
+        reqControls.set(setting.id, value);
+        if (committed != currentControls_.extra.end()) {
+            *committed = setting;
+        } else {
+            currentControls_.extra.push_back(setting);
+        }
+        written++;
     }
 
     // JPEG quality is handled by the encoder, not camera controls
     if (pendingControls_.jpegQuality) {
         currentControls_.jpegQuality = pendingControls_.jpegQuality;
     }
+
+    // Readers get an immutable copy, the applying thread never waits on them
+    if (written || controls.jpegQuality || !published_.load(std::memory_order_relaxed)) {
+        published_.store(std::make_shared<const Controls>(currentControls_), std::memory_order_release);
+    }
+
+    applies_.fetch_add(1, std::memory_order_relaxed);
+    controlsWritten_.fetch_add(written, std::memory_order_relaxed);
+    applyNs_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin).count(), std::memory_order_relaxed);
+}
+
+void ControlManager::invalidate() {
+    // Only valid for the sensor mode picked by the last configure()
+    sensorDurations_ = {0, 0};
+    const auto& infos = camera_->controls();
+    if (auto it = infos.find(&lc::controls::FrameDurationLimits); it != infos.end()) {
+        const auto& min = it->second.min();
+        const auto& max = it->second.max();
+        if (min.type() == lc::ControlTypeInteger64 && !min.isArray()) sensorDurations_[0] = min.get<int64_t>();
+        if (max.type() == lc::ControlTypeInteger64 && !max.isArray()) sensorDurations_[1] = max.get<int64_t>();
+    }
+
+    fullWrite_.store(true, std::memory_order_release);
+}
+
+void ControlManager::reloadTable() {
+    table_ = ControlTable(camera_->controls());
+
+    const auto unsupported = [this](const ControlSetting& setting) { return !table_.find(setting.id); };
+    std::erase_if(pendingControls_.extra, unsupported);
+    std::erase_if(currentControls_.extra, unsupported);
+    published_.store(std::make_shared<const Controls>(currentControls_), std::memory_order_release);
+
+    invalidate();
+}
+
+std::optional<std::array<int64_t, 2>> ControlManager::frameDurationLimits(const Controls& controls) const {
+    if (controls.targetFps && *controls.targetFps > 0) {
+        const int64_t duration = 1000000 / *controls.targetFps;
+        return std::array<int64_t, 2>{duration, duration};
+    }
+
+    if (!controls.minFps && !controls.maxFps && !controls.maxThroughput) return std::nullopt;
+
+    // Without known mode limits the pipeline clamps the open ends itself
+    int64_t shortest = sensorDurations_[0] > 0 ? sensorDurations_[0] : 1;
+    int64_t longest = sensorDurations_[1] > 0 ? sensorDurations_[1] : 1000000;
+
+    if (controls.maxFps && *controls.maxFps > 0 && !controls.maxThroughput.value_or(false)) {
+        shortest = std::max(shortest, static_cast<int64_t>(std::llround(1e6 / *controls.maxFps)));
+    }
+    if (controls.minFps && *controls.minFps > 0) {
+        longest = std::min(longest, static_cast<int64_t>(std::llround(1e6 / *controls.minFps)));
+    }
+
+    return std::array<int64_t, 2>{shortest, std::max(shortest, longest)};
+}
+
+ControlManager::ApplyStats ControlManager::getApplyStats() const {
+    return {applies_, controlsWritten_, applyNs_};
 }
 
 Controls ControlManager::getCurrentControls() const {
-    std::lock_guard lock(mutex_);
-    return currentControls_;
+    auto snapshot = published_.load(std::memory_order_acquire);
+    return snapshot ? *snapshot : Controls{};
 }
 
 ControlManager::Capabilities ControlManager::getCapabilities() const {
@@ -131,10 +231,32 @@ ControlManager::Capabilities ControlManager::getCapabilities() const {
     caps.analogueGain = extractRange(&lc::controls::AnalogueGain);
     caps.lensPosition = extractRange(&lc::controls::LensPosition);
 
-    // Fixed capability lists
-    caps.afModes = {"manual", "auto", "continuous"};
-    caps.awbModes = {"auto", "incandescent", "tungsten", "fluorescent",
-                     "indoor", "daylight", "cloudy", "custom"};
+    // Mode names from the camera's enumerators, e.g. AfModeContinuous
+    // becomes "continuous" and AwbDaylight becomes "daylight"
+    auto modeNames = [this](const char* control, size_t prefix) {
+        std::vector<std::string> names;
+        if (const auto* entry = table_.find(control)) {
+            for (const auto& [value, name] : entry->enumerators) {
+                std::string mode = name.substr(std::min(prefix, name.size()));
+                std::transform(mode.begin(), mode.end(), mode.begin(),
+                               [](unsigned char c) { return std::tolower(c); });
+                names.push_back(mode);
+            }
+        }
+        return names;
+    };
+
+    caps.afModes = modeNames("AfMode", 6);
+    caps.awbModes = modeNames("AwbMode", 3);
+
+    // Fall back to the standard lists on libcamera versions without enumerators
+    if (caps.afModes.empty()) caps.afModes = {"manual", "auto", "continuous"};
+    if (caps.awbModes.empty()) {
+        caps.awbModes = {"auto", "incandescent", "tungsten", "fluorescent",
+                         "indoor", "daylight", "cloudy", "custom"};
+    }
+
+    caps.controls = table_.entries();
 
     return caps;
 }
@@ -0,0 +1,110 @@
+#include "control_table.hpp"
+#include <cmath>
+
+namespace lcam {
+
+namespace {
+
+/**
+ * Numeric scalar as double, NaN for arrays and compound types
+ */
+double toDouble(const lc::ControlValue& value) {
+    if (value.isNone() || value.isArray()) return std::nan("");
+
+    switch (value.type()) {
+        case lc::ControlTypeBool: return value.get<bool>() ? 1 : 0;
+        case lc::ControlTypeByte: return value.get<uint8_t>();
+        case lc::ControlTypeInteger32: return value.get<int32_t>();
+        case lc::ControlTypeInteger64: return static_cast<double>(value.get<int64_t>());
+        case lc::ControlTypeFloat: return value.get<float>();
+        default: return std::nan("");
+    }
+}
+
+template<typename T>
+lc::ControlValue arrayValue(const std::vector<double>& values) {
+    std::vector<T> elements(values.begin(), values.end());
+    return lc::ControlValue(lc::Span<const T>(elements.data(), elements.size()));
+}
+
+}
+
+ControlTable::ControlTable(const lc::ControlInfoMap& infos) {
+    entries_.reserve(infos.size());
+
+    for (const auto& [control, info] : infos) {
+        Entry entry;
+        entry.control = control;
+        entry.id = control->id();
+        entry.name = control->name();
+        entry.type = control->type();
+        entry.isArray = control->isArray();
+        entry.size = control->size();
+        entry.min = toDouble(info.min());
+        entry.max = toDouble(info.max());
+        entry.def = toDouble(info.def());
+
+        for (const auto& [value, name] : control->enumerators()) {
+            entry.enumerators.emplace_back(value, name);
+        }
+
+        entries_.push_back(std::move(entry));
+    }
+
+    std::sort(entries_.begin(), entries_.end(), [](const auto& a, const auto& b) { return a.id < b.id; });
+
+    for (size_t i = 0; i < entries_.size(); i++) {
+        byName_.emplace(entries_[i].name, i);
+    }
+}
+
+const ControlTable::Entry* ControlTable::find(uint32_t id) const {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), id,
+                               [](const Entry& entry, uint32_t key) { return entry.id < key; });
+    return it != entries_.end() && it->id == id ? &*it : nullptr;
+}
+
+const ControlTable::Entry* ControlTable::find(std::string_view name) const {
+    auto it = byName_.find(std::string(name));
+    return it != byName_.end() ? &entries_[it->second] : nullptr;
+}
+
+const ControlTable::Entry* ControlTable::find(const ControlSetting& setting) const {
+    return setting.id ? find(setting.id) : find(setting.name);
+}
+
+lc::ControlValue ControlTable::toValue(const Entry& entry, const std::vector<double>& values) {
+    if (values.empty()) return {};
+    if (entry.size && values.size() != entry.size) return {};
+
+    if (entry.isArray) {
+        switch (entry.type) {
+            case lc::ControlTypeByte: return arrayValue<uint8_t>(values);
+            case lc::ControlTypeInteger32: return arrayValue<int32_t>(values);
+            case lc::ControlTypeInteger64: return arrayValue<int64_t>(values);
+            case lc::ControlTypeFloat: return arrayValue<float>(values);
+            default: return {};
+        }
+    }
+
+    switch (entry.type) {
+        case lc::ControlTypeBool: return lc::ControlValue(values[0] != 0);
+        case lc::ControlTypeByte: return lc::ControlValue(static_cast<uint8_t>(values[0]));
+        case lc::ControlTypeInteger32: return lc::ControlValue(static_cast<int32_t>(values[0]));
+        case lc::ControlTypeInteger64: return lc::ControlValue(static_cast<int64_t>(values[0]));
+        case lc::ControlTypeFloat: return lc::ControlValue(static_cast<float>(values[0]));
+        case lc::ControlTypeRectangle:
+            if (values.size() != 4) return {};
+            return lc::ControlValue(lc::Rectangle(static_cast<int>(values[0]), static_cast<int>(values[1]),
+                                                  static_cast<unsigned int>(values[2]),
+                                                  static_cast<unsigned int>(values[3])));
+        case lc::ControlTypeSize:
+            if (values.size() != 2) return {};
+            return lc::ControlValue(lc::Size(static_cast<unsigned int>(values[0]),
+                                             static_cast<unsigned int>(values[1])));
+        default:
+            return {};
+    }
+}
+
+}
@@ -0,0 +1,51 @@
+#include "frame_ring.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace lcam {
+
+size_t FrameRing::requiredBytes(size_t slots, size_t frameBytes) {
+    return align(kHeaderBytes + slots * kSlotHeaderBytes) + slots * align(frameBytes);
+}
+
+FrameRing::FrameRing(uint8_t* memory, size_t slots, size_t frameBytes)
+    : memory_(memory),
+      slots_(slots),
+      slotSize_(align(frameBytes)),
+      dataOffset_(align(kHeaderBytes + slots * kSlotHeaderBytes)) {
+    std::memset(memory_, 0, dataOffset_);
+    *word(4) = static_cast<int32_t>(slots_);
+    *word(8) = static_cast<int32_t>(slotSize_);
+    *word(12) = static_cast<int32_t>(dataOffset_);
+    *word(16) = -1;
+}
+
+uint32_t FrameRing::write(const Frame& frame) {
+    const uint32_t slot = next_;
+    next_ = (next_ + 1) % slots_;
+
+    uint8_t* header = memory_ + kHeaderBytes + slot * kSlotHeaderBytes;
+    std::atomic_ref<int32_t> version(*reinterpret_cast<int32_t*>(header));
+
+    // Readers that see an odd version, or a different one after reading,
+    // discard what they read
+    const int32_t start = version.load(std::memory_order_relaxed);
+    version.store(start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const uint32_t bytes = static_cast<uint32_t>(std::min(frame.data.size(), slotSize_));
+    std::memcpy(memory_ + dataOffset_ + slot * slotSize_, frame.data.data(), bytes);
+    std::memcpy(header + 4, &frame.sequence, sizeof(uint32_t));
+    std::memcpy(header + 8, &frame.streamId, sizeof(uint32_t));
+    std::memcpy(header + 12, &bytes, sizeof(uint32_t));
+    std::memcpy(header + 16, &frame.timestamp, sizeof(uint64_t));
+
+    version.store(start + 2, std::memory_order_release);
+    std::atomic_ref<int32_t>(*word(16)).store(static_cast<int32_t>(slot), std::memory_order_relaxed);
+    std::atomic_ref<int32_t>(*word(0)).fetch_add(1, std::memory_order_release);
+
+    return slot;
+}
+
+}
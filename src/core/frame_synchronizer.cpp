@@ -0,0 +1,101 @@
+#include "frame_synchronizer.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace lcam {
+
+FrameSynchronizer::FrameSynchronizer(uint64_t toleranceNs, size_t maxPending, PairCallback callback)
+    : toleranceNs_(toleranceNs), maxPending_(std::max<size_t>(maxPending, 2)),
+      callback_(std::move(callback)) {}
+
+void FrameSynchronizer::push(Side side, const Frame& frame) {
+    Frame owned = frame;
+
+    // Zero-copy frames point into buffers that get requeued, keep a copy
+    if (!owned.owner) {
+        auto copy = std::make_shared<std::vector<uint8_t>>(frame.data.begin(), frame.data.end());
+        owned.data = std::span<const uint8_t>(copy->data(), copy->size());
+        owned.owner = std::static_pointer_cast<void>(copy);
+    }
+
+    std::vector<FramePair> matched;
+
+    {
+        std::lock_guard lock(mutex_);
+
+        auto& queue = pending_[side];
+        queue.push_back(std::move(owned));
+
+        // The other side stalled, don't let this one grow without bound
+        if (queue.size() > maxPending_) drop(side);
+
+        auto& left = pending_[LEFT];
+        auto& right = pending_[RIGHT];
+
+        while (!left.empty() && !right.empty()) {
+            // Everything still to come is newer than both fronts, so the
+            // older front can only ever pair with the other side's front
+            const Side older = left.front().timestamp <= right.front().timestamp ? LEFT : RIGHT;
+            const auto& olderQueue = pending_[older];
+            const auto& candidate = pending_[1 - older].front();
+
+            const uint64_t distance = candidate.timestamp - olderQueue.front().timestamp;
+            if (distance > toleranceNs_) {
+                drop(older);
+                continue;
+            }
+
+            // A later frame on the same side sits closer to the candidate
+            if (olderQueue.size() > 1) {
+                const uint64_t next = olderQueue[1].timestamp;
+                const uint64_t nextDistance = next > candidate.timestamp
+                                                  ? next - candidate.timestamp
+                                                  : candidate.timestamp - next;
+                if (nextDistance < distance) {
+                    drop(older);
+                    continue;
+                }
+            }
+
+            FramePair pair{
+                std::move(left.front()),
+                std::move(right.front()),
+                0
+            };
+            pair.skew = static_cast<int64_t>(pair.right.timestamp) -
+                        static_cast<int64_t>(pair.left.timestamp);
+            left.pop_front();
+            right.pop_front();
+
+            stats_.pairs++;
+            stats_.lastSkew = pair.skew;
+            matched.push_back(std::move(pair));
+        }
+    }
+
+    for (const auto& pair : matched) {
+        callback_(pair);
+    }
+}
+
+void FrameSynchronizer::drop(Side side) {
+    pending_[side].pop_front();
+    if (side == LEFT) {
+        stats_.droppedLeft++;
+    } else {
+        stats_.droppedRight++;
+    }
+}
+
+void FrameSynchronizer::reset() {
+    std::lock_guard lock(mutex_);
+    pending_[LEFT].clear();
+    pending_[RIGHT].clear();
+}
+
+FrameSynchronizer::Stats FrameSynchronizer::stats() const {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+}
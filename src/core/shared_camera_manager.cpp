@@ -0,0 +1,69 @@
+#include "shared_camera_manager.hpp"
+#include <iostream>
+
+namespace lcam {
+
+std::mutex SharedCameraManager::mutex_;
+std::weak_ptr<lc::CameraManager> SharedCameraManager::instance_;
+
+std::shared_ptr<lc::CameraManager> SharedCameraManager::acquire() {
+    std::lock_guard lock(mutex_);
+
+    if (auto manager = instance_.lock()) {
+        return manager;
+    }
+
+    // Stop the manager once the last camera or enumeration lets go of it
+    std::shared_ptr<lc::CameraManager> manager(new lc::CameraManager(), [](lc::CameraManager* m) {
+        m->stop();
+        delete m;
+    });
+
+    if (manager->start() < 0) {
+        std::cerr << "Failed to start libcamera camera manager" << std::endl;
+        return nullptr;
+    }
+
+    instance_ = manager;
+    return manager;
+}
+
+std::vector<CameraInfo> SharedCameraManager::listCameras() {
+    std::vector<CameraInfo> result;
+
+    const auto manager = acquire();
+    if (!manager) return result;
+
+    for (const auto& camera : manager->cameras()) {
+        const auto& props = camera->properties();
+        CameraInfo info;
+        info.id = camera->id();
+        info.model = props.get(lc::properties::Model).value_or("");
+
+        switch (props.get(lc::properties::Location).value_or(-1)) {
+            case lc::properties::CameraLocationFront:
+                info.location = "front";
+                break;
+            case lc::properties::CameraLocationBack:
+                info.location = "back";
+                break;
+            case lc::properties::CameraLocationExternal:
+                info.location = "external";
+                break;
+            default:
+                info.location = "unknown";
+                break;
+        }
+
+        if (const auto size = props.get(lc::properties::PixelArraySize)) {
+            info.pixelArrayWidth = size->width;
+            info.pixelArrayHeight = size->height;
+        }
+
+        result.push_back(std::move(info));
+    }
+
+    return result;
+}
+
+}
@@ -13,9 +13,14 @@ namespace lcam {
     }
 
     bool StreamManager::configure(const std::optional<StreamConfig>& rawStream,
-                                  const std::vector<StreamConfig> &configs) {
+                                  const std::vector<StreamConfig> &configs,
+                                  size_t heldRequests) {
+        // Nothing counts as configured until libcamera accepted the new configuration
+        streamInfos_.clear();
+
         std::vector<lc::StreamRole> roles;
         std::vector<StreamConfig> allConfigs;
+        std::vector<uint32_t> streamIds;
 
         // Add RAW stream first if requested
         if (rawStream) {
@@ -30,9 +35,11 @@ namespace lcam {
                 .height = 1296
             });
         }
+        streamIds.push_back(kRawStreamId);
 
         // Add user-requested streams
-        for (const auto &cfg: configs) {
+        for (size_t id = 0; id < configs.size(); ++id) {
+            const auto &cfg = configs[id];
             switch (cfg.type) {
                 case StreamType::JPEG:
                     roles.push_back(lc::StreamRole::StillCapture);
@@ -40,11 +47,15 @@ namespace lcam {
                 case StreamType::RGB:
                     roles.push_back(lc::StreamRole::StillCapture);
                     break;
+                case StreamType::STILL:
+                    roles.push_back(lc::StreamRole::StillCapture);
+                    break;
                 case StreamType::RAW:
                     // Skip duplicate RAW
                     continue;
             }
             allConfigs.push_back(cfg);
+            streamIds.push_back(static_cast<uint32_t>(id));
         }
 
         config_ = camera_->generateConfiguration(roles);
@@ -53,7 +64,7 @@ namespace lcam {
             return false;
         }
 
-        streamTypes_.clear();
+        bufferCount_ = kBaseBufferCount + heldRequests;
 
         // Configure each stream
         for (size_t i = 0; i < allConfigs.size(); ++i) {
@@ -64,7 +75,7 @@ namespace lcam {
             if (appCfg.width > 0) streamCfg.size.width = appCfg.width;
             if (appCfg.height > 0) streamCfg.size.height = appCfg.height;
 
-            streamCfg.bufferCount = 6;  // Sufficient for smooth operation
+            streamCfg.bufferCount = bufferCount_;  // Sufficient for smooth operation
 
             // Set pixel format based on stream type
             switch (appCfg.type) {
@@ -72,10 +83,8 @@ namespace lcam {
                     streamCfg.pixelFormat = lc::formats::RGB888;
                     break;
                 case StreamType::JPEG:
+                case StreamType::STILL:
                     streamCfg.pixelFormat = lc::formats::YUV420;
-                    // Cache dimensions for encoder
-                    jpegWidth_ = streamCfg.size.width;
-                    jpegHeight_ = streamCfg.size.height;
                     break;
                 case StreamType::RAW:
                     streamCfg.pixelFormat = lc::formats::SBGGR10;  // Bayer pattern
@@ -93,9 +102,21 @@ namespace lcam {
             return false;
         }
 
-        // Map configured streams to their types
+        // Cache per-stream geometry after validation may have adjusted it
         for (size_t i = 0; i < allConfigs.size(); ++i) {
-            streamTypes_[config_->at(i).stream()] = allConfigs[i].type;
+            const auto &streamCfg = config_->at(i);
+            const auto type = allConfigs[i].type;
+            const uint32_t packedStride = type == StreamType::RGB
+                                              ? streamCfg.size.width * 3
+                                              : streamCfg.size.width;
+
+            streamInfos_[streamCfg.stream()] = {
+                .type = type,
+                .id = streamIds[i],
+                .width = streamCfg.size.width,
+                .height = streamCfg.size.height,
+                .stride = streamCfg.stride ? streamCfg.stride : packedStride
+            };
         }
 
         return true;
@@ -119,8 +140,7 @@ namespace lcam {
                 auto *fb = buffer.get();
                 bufferPtrs.push_back(fb);
 
-                if (!mapBuffer(fb, streamTypes_[stream],
-                               streamCfg.size.width, streamCfg.size.height)) {
+                if (!mapBuffer(fb, streamInfos_.at(stream))) {
                     std::cerr << "Failed to map buffer" << std::endl;
                     return false;
                 }
@@ -130,9 +150,9 @@ namespace lcam {
         }
 
         // Create capture requests
-        const size_t numRequests = 6;  // Match buffer count
+        const size_t numRequests = bufferCount_;  // Match buffer count
         for (size_t i = 0; i < numRequests; ++i) {
-            auto request = camera_->createRequest();
+            auto request = camera_->createRequest(i);  // Cookie is the request index
             if (!request) {
                 std::cerr << "Failed to create capture request" << std::endl;
                 return false;
@@ -154,22 +174,22 @@ namespace lcam {
         return true;
     }
 
-    bool StreamManager::mapBuffer(lc::FrameBuffer *buffer, StreamType type,
-                                  uint32_t width, uint32_t height) {
+    bool StreamManager::mapBuffer(lc::FrameBuffer *buffer, const StreamInfo &info) {
         // Skip mapping RAW buffers to save memory
-        if (type == StreamType::RAW) return true;
+        if (info.type == StreamType::RAW) return true;
 
         const auto &planes = buffer->planes();
         if (planes.empty()) return false;
 
         size_t totalSize = 0;
 
-        switch (type) {
+        switch (info.type) {
             case StreamType::JPEG:
-                totalSize = width * height * 3 / 2; // YUV420
+            case StreamType::STILL:
+                totalSize = info.stride * info.height * 3 / 2; // YUV420
                 break;
             case StreamType::RGB:
-                totalSize = width * height * 3; // BGR888
+                totalSize = info.stride * info.height; // BGR888
                 break;
             default:
                 return true;
@@ -213,8 +233,13 @@ namespace lcam {
     }
 
     StreamType StreamManager::getStreamType(const lc::Stream *stream) const {
-        const auto it = streamTypes_.find(stream);
-        return it != streamTypes_.end() ? it->second : StreamType::RAW;
+        const auto it = streamInfos_.find(stream);
+        return it != streamInfos_.end() ? it->second.type : StreamType::RAW;
+    }
+
+    const StreamManager::StreamInfo *StreamManager::getStreamInfo(const lc::Stream *stream) const {
+        const auto it = streamInfos_.find(stream);
+        return it != streamInfos_.end() ? &it->second : nullptr;
     }
 
     lc::FrameBuffer *StreamManager::getBuffer(const lc::Stream *stream, size_t index) {
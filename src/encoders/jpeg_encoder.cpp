@@ -5,7 +5,7 @@
 namespace lcam {
 
 JpegEncoder::JpegEncoder(size_t maxQueueSize)
-    : tjHandle_(tjInitCompress()), maxQueueSize_(maxQueueSize) {
+    : tjHandle_(tjInitCompress()), maxQueueSize_(std::max<size_t>(maxQueueSize, 1)) {
     if (!tjHandle_) {
         throw std::runtime_error("Failed to initialize TurboJPEG");
     }
@@ -31,46 +31,69 @@ void JpegEncoder::stop() {
         if (worker_.joinable()) {
             worker_.join();
         }
+
+        // Drop frames of the previous run so a restart starts fresh
+        std::lock_guard lock(mutex_);
+        std::queue<Task>().swap(queue_);
     }
 }
 
 void JpegEncoder::encode(const uint8_t* yuvData, uint32_t width, uint32_t height,
-                        int quality, uint64_t timestamp, uint32_t sequence,
+                        uint32_t stride, int quality, const Frame& info,
                         FrameCallback callback) {
+    // Never waits: the caller requeues the camera buffer after this, so a
+    // slow encoder drops its own frames instead of stalling capture
+    if (!hasRoom()) return;
+
     // Copy YUV data to avoid it being overwritten during encoding
-    size_t dataSize = width * height * 3 / 2;  // YUV420
+    size_t dataSize = stride * height * 3 / 2;  // YUV420
     auto dataCopy = std::make_shared<std::vector<uint8_t>>(yuvData, yuvData + dataSize);
 
     {
-        std::unique_lock<std::mutex> lock(mutex_);
-
-        // Apply backpressure instead of dropping frames
-        cv_.wait(lock, [this] {
-            return queue_.size() < maxQueueSize_ || !running_;
-        });
-
+        std::lock_guard<std::mutex> lock(mutex_);
         if (!running_) return;
-
-        // Warn if queue is getting full
-        if (queue_.size() >= maxQueueSize_ - 2) {
-            std::cerr << "JPEG encoder queue nearly full ("
-                      << queue_.size() << "/" << maxQueueSize_ << ")" << std::endl;
+        if (queue_.size() >= maxQueueSize_) {
+            framesDropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
 
         queue_.push({
             dataCopy->data(),
             width,
             height,
+            stride,
             quality,
-            timestamp,
-            sequence,
+            info,
             callback,
-            dataCopy  // Keep data alive
+            dataCopy,  // Keep data alive
+            std::chrono::steady_clock::now()
         });
     }
     cv_.notify_one();
 }
 
+bool JpegEncoder::hasRoom() {
+    std::lock_guard lock(mutex_);
+    if (!running_) return false;
+    if (queue_.size() < maxQueueSize_) return true;
+
+    framesDropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+size_t JpegEncoder::queueDepth() const {
+    std::lock_guard lock(mutex_);
+    return queue_.size();
+}
+
+double JpegEncoder::oldestQueuedMs() const {
+    std::lock_guard lock(mutex_);
+    if (queue_.empty()) return 0;
+
+    const auto age = std::chrono::steady_clock::now() - queue_.front().queuedAt;
+    return std::chrono::duration<double, std::milli>(age).count();
+}
+
 void JpegEncoder::workerThread() {
     while (running_) {
         Task task;
@@ -85,19 +108,16 @@ void JpegEncoder::workerThread() {
             queue_.pop();
         }
 
-        // Notify waiting encoders that queue has space
-        cv_.notify_all();
-
         // Setup YUV plane pointers
         const uint8_t* planes[3];
         planes[0] = task.data;  // Y plane
-        planes[1] = task.data + (task.width * task.height);  // U plane
-        planes[2] = planes[1] + (task.width * task.height) / 4;  // V plane
+        planes[1] = task.data + (task.stride * task.height);  // U plane
+        planes[2] = planes[1] + (task.stride * task.height) / 4;  // V plane
 
         int strides[3] = {
-            static_cast<int>(task.width),
-            static_cast<int>(task.width / 2),
-            static_cast<int>(task.width / 2)
+            static_cast<int>(task.stride),
+            static_cast<int>(task.stride / 2),
+            static_cast<int>(task.stride / 2)
         };
 
         // Ensure output buffer is large enough
@@ -122,15 +142,14 @@ void JpegEncoder::workerThread() {
                 buffer_.begin(), buffer_.begin() + jpegSize
             );
 
-            Frame frame{
-                std::span<const uint8_t>(bufferCopy->data(), bufferCopy->size()),
-                task.timestamp,
-                task.sequence,
-                std::static_pointer_cast<void>(bufferCopy)
-            };
+            Frame frame = task.info;
+            frame.data = std::span<const uint8_t>(bufferCopy->data(), bufferCopy->size());
+            frame.owner = std::static_pointer_cast<void>(bufferCopy);
 
+            framesEncoded_.fetch_add(1, std::memory_order_relaxed);
             task.callback(StreamType::JPEG, frame);
         } else {
+            encodeErrors_.fetch_add(1, std::memory_order_relaxed);
             std::cerr << "JPEG encoding failed: " << tjGetErrorStr() << std::endl;
         }
     }
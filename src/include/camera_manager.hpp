@@ -10,10 +10,79 @@ class StreamManager;
 class JpegEncoder;
 
 struct CameraConfig {
+    std::string cameraId;  // libcamera camera id, empty selects the first camera
     std::optional<StreamConfig> rawStream;  // Optional RAW stream configuration
     std::vector<StreamConfig> streams;
     Controls initialControls;
     size_t jpegEncoderQueueSize = 33;  // Configurable JPEG encoder queue size
+    bool earlyDelivery = false;  // Dispatch each buffer as soon as it completes
+    size_t zslDepth = 3;         // Recent frames held back when a STILL stream is configured
+    uint32_t stallTimeoutMs = 0; // Watchdog threshold, 0 disables the watchdog
+    bool autoRecover = false;    // Restart the pipeline when the watchdog reports a stall
+    bool groupedDelivery = false;  // One FrameGroup per request instead of per-stream frames
+    uint32_t groupDeadlineMs = 100;  // Deliver a group without outputs that are still encoding
+    bool writeAllControls = false;   // Write every set control into each request, not only changes
+};
+
+/**
+ * Geometry of a configured stream's frames
+ */
+struct StreamLayout {
+    StreamType type;
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;      // Bytes per line
+    size_t frameBytes;    // Largest frame the stream delivers uncompressed
+};
+
+/**
+ * Milliseconds spent in each phase of the last initialize(), start(),
+ * stop() or reconfigure(), 0 for phases it skipped
+ */
+struct LifecycleTimings {
+    double managerStartMs = 0;  // Process-wide libcamera manager, near 0 when already running
+    double acquireMs = 0;
+    double configureMs = 0;     // Stream configuration, encoders and controls
+    double allocateMs = 0;      // Buffer allocation and mapping, 0 when buffers were kept
+    double startMs = 0;         // Starting the camera and queueing the requests
+    double firstFrameMs = 0;    // Start until the first frame, 0 until it arrived
+    double stopMs = 0;
+};
+
+/**
+ * Per-instance runtime counters
+ */
+struct CameraStats {
+    std::string cameraId;
+    uint64_t requestsCompleted = 0;
+    double achievedFps = 0;       // From per-frame FrameDuration, smoothed over about 8 frames
+    uint64_t rgbFramesDelivered = 0;
+    uint64_t jpegFramesEncoded = 0;
+    uint64_t jpegEncodeErrors = 0;
+    uint64_t jpegFramesSkipped = 0;  // Frames of on-demand streams nobody asked for
+    uint64_t jpegFramesDropped = 0;  // Frames an encoder had no queue room for
+    size_t jpegQueueDepth = 0;    // Frames currently waiting in all JPEG encoders
+    uint64_t reconfigures = 0;
+    double lastStartMs = 0;       // start() or restart until the first frame
+    double lastBlackoutMs = 0;    // reconfigure() call until the first new frame
+    bool paused = false;
+    uint64_t resumes = 0;
+    double lastResumeMs = 0;      // resume() call until the first frame
+    uint64_t stillsCaptured = 0;
+    uint64_t stillsDropped = 0;   // captureStill() calls the still encoder had no queue room for
+    size_t stillQueueDepth = 0;   // Stills waiting to be encoded
+    uint64_t controlApplies = 0;      // Requests that received control changes
+    uint64_t controlsWritten = 0;     // Individual controls written to those requests
+    double controlApplyAvgUs = 0;     // ControlList population cost per request
+    uint64_t groupsDelivered = 0;
+    uint64_t groupsIncomplete = 0;  // Groups delivered at the deadline with outputs missing
+    size_t requestsInFlight = 0;  // Requests queued to libcamera and not yet completed
+    uint64_t stalls = 0;
+    uint64_t recoveries = 0;
+    double lastRecoveryMs = 0;    // Stall detection until the first frame after the restart
+    uint64_t completionCallbacks = 0;      // libcamera completion signals handled
+    double completionCallbackAvgUs = 0;    // Time spent on libcamera's thread per signal
+    double completionCallbackMaxUs = 0;
 };
 
 /**
@@ -33,21 +102,104 @@ public:
     /**
      * Start camera streaming
      * @param frameCallback Called for each captured frame
-     * @param errorCallback Called on errors
+     * @param errorCallback Called on start failures and watchdog stalls,
+     *        possibly from the watchdog thread
+     * @param groupCallback Receives JPEG and RGB outputs per request when
+     *        groupedDelivery is set; stills still go to frameCallback
      * @return true on success
      */
-    bool start(FrameCallback frameCallback, ErrorCallback errorCallback) const;
+    bool start(FrameCallback frameCallback, ErrorCallback errorCallback,
+               GroupCallback groupCallback = nullptr) const;
 
     /**
-     * Stop camera streaming
+     * Register an additional native frame consumer, e.g. a synchronizer.
+     * Listeners run on the delivering thread and must not block.
+     * @return Listener id for removeFrameListener
+     */
+    uint32_t addFrameListener(FrameCallback listener);
+
+    /**
+     * Unregister a frame consumer added with addFrameListener
+     */
+    void removeFrameListener(uint32_t id);
+
+    /**
+     * Stop camera streaming. The camera stays acquired and its buffers stay
+     * mapped, so start() can be called again.
      */
     void stop() const;
 
+    /**
+     * Stop queueing capture requests while keeping the camera started,
+     * buffers mapped and encoder threads parked
+     * @return false if the camera is not running
+     */
+    bool pause() const;
+
+    /**
+     * Requeue the requests held back by pause()
+     * @return false if the camera is not running
+     */
+    bool resume() const;
+
+    /**
+     * Encode a JPEG from the zero-shutter-lag ring of the STILL stream.
+     * Returns right away, the frame is copied and encoded on the still
+     * thread and delivered as a StreamType::STILL frame.
+     * @param at Sensor timestamp to match, 0 for the most recent frame
+     * @return false if no STILL stream is configured or the ring is empty
+     */
+    bool captureStill(uint64_t at = 0) const;
+
+    /**
+     * Apply a new stream configuration without releasing the camera.
+     * Restarts streaming if it was running; buffers and mappings are kept
+     * when the stream geometry is unchanged.
+     * @return true on success
+     */
+    bool reconfigure(const CameraConfig& config) const;
+
     /**
      * Apply new control values (queued for next frame)
      */
     bool setControls(const Controls& controls);
 
+    /**
+     * Attach controls to one specific future request. Requests already
+     * queued are not affected, so the frame carrying them is delivered
+     * after the frames in flight.
+     * @param framesAhead Requests to skip before the one that carries them,
+     *        0 for the next request queued
+     * @return Tag reported in FrameMetadata::ControlTag of that frame
+     */
+    uint32_t scheduleControls(const Controls& controls, uint32_t framesAhead = 0);
+
+    /**
+     * Cycle through control sets on consecutive requests, e.g. exposures
+     * for HDR brackets, until replaced. An empty list stops bracketing and
+     * leaves the last set in effect.
+     * @return Tag of each set, reported in FrameMetadata::ControlTag
+     */
+    std::vector<uint32_t> setBracket(const std::vector<Controls>& sets);
+
+    /**
+     * Zoom and pan in the ISP by setting ScalerCrop, so every stream is
+     * scaled from the cropped area. The crop moves towards the region over
+     * consecutive requests and each frame reports the crop it was captured
+     * with in FrameMetadata::CropX to CropHeight.
+     * @param transitionFrames Requests to ease over, 0 jumps on the next one
+     * @return false if the camera has no ScalerCrop or the region is empty
+     *         or outside 0, 0, 1, 1
+     */
+    bool setCrop(const CropRegion& region, uint32_t transitionFrames = 0);
+
+    /**
+     * Let an on-demand JPEG stream encode its next frame. Requests made
+     * before that frame arrives are served by the same frame.
+     * @return false if the stream is not an on-demand JPEG stream
+     */
+    bool requestFrame(uint32_t streamId);
+
     /**
      * Get current control values
      */
@@ -58,6 +210,38 @@ public:
      */
     ControlManager::Capabilities getCapabilities() const;
 
+    /**
+     * Whether streaming is running, e.g. after a failed reconfigure()
+     * stopped it
+     */
+    bool isRunning() const;
+
+    /**
+     * Get runtime counters for this camera instance
+     */
+    CameraStats getStats() const;
+
+    /**
+     * Phase timings of the last lifecycle operation
+     */
+    LifecycleTimings getTimings() const;
+
+    /**
+     * Block until the first frame after start() or reconfigure() arrived
+     * @return false on timeout or if streaming stopped first
+     */
+    bool waitForFirstFrame(uint32_t timeoutMs) const;
+
+    /**
+     * Reason for the last failed initialize(), start() or reconfigure()
+     */
+    std::string lastError() const;
+
+    /**
+     * Geometry of the stream with the given id in the current configuration
+     */
+    std::optional<StreamLayout> getStreamLayout(uint32_t streamId) const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> pImpl;
@@ -9,6 +9,8 @@
 #include <chrono>
 #include <vector>
 #include <array>
+#include <limits>
+#include <algorithm>
 
 namespace lc = libcamera;
 namespace lcam {
@@ -16,13 +18,62 @@ namespace lcam {
 enum class StreamType {
     JPEG,
     RGB,
-    RAW
+    RAW,
+    STILL   // Full resolution YUV held for zero-shutter-lag JPEG stills
 };
 
 struct StreamConfig {
     StreamType type;
     uint32_t width = 0;  // 0 means use camera default
     uint32_t height = 0; // 0 means use camera default
+    std::optional<int32_t> quality;  // JPEG only, overrides controls.jpegQuality
+    bool onDemand = false;  // JPEG only, encode only frames asked for with requestFrame()
+};
+
+/**
+ * Per-frame results read once from the request metadata. Values are kept
+ * as doubles in a fixed order so they copy straight into a Float64Array;
+ * NaN when the pipeline did not report a value.
+ */
+struct FrameMetadata {
+    enum Field : size_t {
+        ExposureTime,       // Microseconds
+        AnalogueGain,
+        DigitalGain,
+        Lux,
+        ColourTemperature,  // Kelvin
+        FocusFoM,
+        AfState,
+        FrameDuration,      // Microseconds
+        ControlTag,         // Scheduled or bracketed control set, 0 if none
+        CropX,              // Effective ScalerCrop, relative to ScalerCropMaximum
+        CropY,
+        CropWidth,
+        CropHeight,
+        FieldCount
+    };
+
+    FrameMetadata() {
+        values.fill(std::numeric_limits<double>::quiet_NaN());
+        values[ControlTag] = 0;
+    }
+
+    double operator[](Field field) const { return values[field]; }
+
+    std::array<double, FieldCount> values;
+};
+
+/**
+ * Sensor area scaled into the output streams, relative to the largest crop
+ * the ISP supports: 0, 0, 1, 1 is the full field of view
+ */
+struct CropRegion {
+    double x = 0;
+    double y = 0;
+    double width = 1;
+    double height = 1;
+
+    bool operator==(const CropRegion&) const = default;
 };
 
 struct Frame {
@@ -30,6 +81,25 @@ struct Frame {
     uint64_t timestamp;    // Nanoseconds since epoch
     uint32_t sequence;     // Frame sequence number
     std::shared_ptr<void> owner;  // Keeps underlying buffer alive
+    uint32_t streamId = 0; // Index of the stream in CameraConfig::streams
+    FrameMetadata metadata;
+};
+
+/**
+ * Any libcamera control, addressed by numeric id or by name. Values are
+ * converted to the control's type when applied: a scalar, the elements of
+ * an array control, or x, y, width, height for rectangles.
+ */
+struct ControlSetting {
+    uint32_t id = 0;             // libcamera control id, 0 to look up by name
+    std::string name;
+    std::vector<double> values;
+
+    bool sameControl(const ControlSetting& other) const {
+        return id && other.id ? id == other.id : name == other.name;
+    }
+
+    bool operator==(const ControlSetting&) const = default;
 };
 
 struct Controls {
@@ -54,8 +124,25 @@ struct Controls {
     std::optional<float> sharpness;
 
     // Performance
-    std::optional<int32_t> targetFps;       // Target frame rate
+    std::optional<int32_t> targetFps;       // Fixed frame rate
+    std::optional<float> minFps;            // Frame rate range instead of a fixed rate, AE may
+    std::optional<float> maxFps;            // lengthen frames down to minFps in low light
+    std::optional<bool> maxThroughput;      // Shortest frame duration of the sensor mode, ignores maxFps
     std::optional<int32_t> jpegQuality;     // 1-100, higher is better
+
+    // Any other control the camera reports, e.g. ScalerCrop or AeMeteringMode
+    std::vector<ControlSetting> extra;
+};
+
+/**
+ * Outputs of all streams of one capture request, delivered together
+ */
+struct FrameGroup {
+    uint32_t sequence = 0;
+    uint64_t timestamp = 0;
+    FrameMetadata metadata;
+    std::vector<std::pair<StreamType, Frame>> frames;  // Ordered by stream id
+    bool complete = false;  // False if some JPEG output missed the deadline
 };
 
 // Helper template to reduce boilerplate
@@ -64,7 +151,66 @@ inline void assignIfSet(std::optional<T>& target, const std::optional<T>& source
     if (source) target = source;
 }
 
+/**
+ * Overwrite the fields of target that are set in source
+ */
+inline void mergeControls(Controls& target, const Controls& source) {
+    assignIfSet(target.exposureMode, source.exposureMode);
+    assignIfSet(target.exposureTime, source.exposureTime);
+    assignIfSet(target.analogueGain, source.analogueGain);
+    assignIfSet(target.afMode, source.afMode);
+    assignIfSet(target.afTrigger, source.afTrigger);
+    assignIfSet(target.lensPosition, source.lensPosition);
+    assignIfSet(target.awbMode, source.awbMode);
+    assignIfSet(target.colourGains, source.colourGains);
+    assignIfSet(target.brightness, source.brightness);
+    assignIfSet(target.contrast, source.contrast);
+    assignIfSet(target.saturation, source.saturation);
+    assignIfSet(target.sharpness, source.sharpness);
+    assignIfSet(target.jpegQuality, source.jpegQuality);
+
+    // A fixed rate and a range are alternatives, the later one wins
+    if (source.targetFps) {
+        target.minFps.reset();
+        target.maxFps.reset();
+        target.maxThroughput.reset();
+    } else if (source.minFps || source.maxFps || source.maxThroughput) {
+        target.targetFps.reset();
+    }
+    assignIfSet(target.targetFps, source.targetFps);
+    assignIfSet(target.minFps, source.minFps);
+    assignIfSet(target.maxFps, source.maxFps);
+    assignIfSet(target.maxThroughput, source.maxThroughput);
+
+    for (const auto& setting : source.extra) {
+        auto it = std::find_if(target.extra.begin(), target.extra.end(),
+                               [&](const auto& existing) { return existing.sameControl(setting); });
+        if (it != target.extra.end()) {
+            *it = setting;
+        } else {
+            target.extra.push_back(setting);
+        }
+    }
+}
+
 using FrameCallback = std::function<void(StreamType type, const Frame& frame)>;
-using ErrorCallback = std::function<void(const std::string& error)>;
+enum class ErrorCode {
+    Unknown,
+    StartFailed,      // Buffers could not be allocated or capture did not start
+    Stalled,          // No request completed or encoded within the stall threshold
+    RecoveryFailed,   // Automatic restart after a stall did not succeed
+    ReconfigureFailed // New streams were rejected, the previous ones are restored if possible
+};
+
+struct CameraError {
+    ErrorCode code = ErrorCode::Unknown;
+    std::string message;
+    double stalledMs = 0;     // Age of the stall when it was detected
+    bool recovering = false;  // An automatic restart follows this error
+    int64_t streamId = -1;    // Stream that stalled, -1 if none
+};
+
+using ErrorCallback = std::function<void(const CameraError& error)>;
+using GroupCallback = std::function<void(const FrameGroup& group)>;
 
 }
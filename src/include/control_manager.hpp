@@ -1,26 +1,62 @@
 #pragma once
 
 #include "common.hpp"
-#include <mutex>
+#include "control_table.hpp"
+#include <atomic>
 
 namespace lcam {
 
 /**
- * Manages camera controls and tracks their state
+ * Manages camera controls and tracks their state. applyControls() and
+ * invalidate() are called from one thread at a time (the dispatch thread
+ * while streaming); the getters may be called from any thread.
  */
 class ControlManager {
 public:
     ControlManager(std::shared_ptr<lc::Camera> camera);
 
     /**
-     * Apply control changes to a capture request
+     * Apply control changes to a capture request. Only controls that differ
+     * from the values already committed to the pipeline are written.
      * @param controls New control values to apply
      * @param request Target request to modify
      */
     void applyControls(const Controls& controls, lc::Request* request);
 
     /**
-     * Get snapshot of current control values
+     * Write every known control with the next request, e.g. after the
+     * camera was restarted and the pipeline state is unknown. Also re-reads
+     * the frame duration limits of the configured sensor mode.
+     */
+    void invalidate();
+
+    /**
+     * Re-read the supported controls after the camera was configured with
+     * new streams, whose sensor mode can change them. Generic controls the
+     * camera no longer supports are dropped, the rest is written again.
+     */
+    void reloadTable();
+
+    /**
+     * Write every set control with each apply instead of only the changed
+     * ones, e.g. to measure what the diff saves
+     */
+    void setWriteAll(bool enabled) { writeAll_.store(enabled, std::memory_order_relaxed); }
+
+    /**
+     * Cost of populating request control lists
+     */
+    struct ApplyStats {
+        uint64_t applies = 0;
+        uint64_t controlsWritten = 0;
+        int64_t totalNs = 0;
+    };
+
+    ApplyStats getApplyStats() const;
+
+    /**
+     * Get snapshot of current control values, without blocking the
+     * thread that applies them
      */
     Controls getCurrentControls() const;
 
@@ -34,6 +70,7 @@ public:
         std::optional<Range> lensPosition;    // Focus distance
         std::vector<std::string> afModes;
         std::vector<std::string> awbModes;
+        std::vector<ControlTable::Entry> controls;  // Everything the camera supports
     };
 
     /**
@@ -41,11 +78,36 @@ public:
      */
     Capabilities getCapabilities() const;
 
+    /**
+     * Controls supported by the camera, by id and by name
+     */
+    const ControlTable& table() const { return table_; }
+
 private:
+    /**
+     * Fill in id and name of generic settings, dropping unknown controls
+     */
+    std::vector<ControlSetting> resolve(const std::vector<ControlSetting>& settings) const;
+
+    /**
+     * FrameDurationLimits in microseconds for a fixed rate or a range,
+     * nullopt if the controls set neither
+     */
+    std::optional<std::array<int64_t, 2>> frameDurationLimits(const Controls& controls) const;
+
     std::shared_ptr<lc::Camera> camera_;
-    mutable std::mutex mutex_;
-    Controls currentControls_;  // Last applied values
-    Controls pendingControls_;  // Merged pending changes
+    ControlTable table_;
+    Controls currentControls_;  // Last values committed to the pipeline
+    Controls pendingControls_;  // Merged desired values
+    std::atomic<std::shared_ptr<const Controls>> published_;  // Copy of currentControls_ for readers
+    std::atomic<bool> fullWrite_{true};  // Ignore the diff on the next apply
+    std::atomic<bool> writeAll_{false};  // Ignore the diff on every apply
+    std::optional<std::array<int64_t, 2>> committedLimits_;  // FrameDurationLimits last written
+    std::array<int64_t, 2> sensorDurations_{0, 0};  // Of the configured sensor mode, 0 if unknown
+
+    std::atomic<uint64_t> applies_{0};
+    std::atomic<uint64_t> controlsWritten_{0};
+    std::atomic<int64_t> applyNs_{0};
 };
 
 }
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "common.hpp"
+#include <unordered_map>
+#include <string_view>
+
+namespace lcam {
+
+/**
+ * Every control the camera supports, enumerated once from its
+ * ControlInfoMap and indexed by numeric id and by name
+ */
+class ControlTable {
+public:
+    struct Entry {
+        const lc::ControlId* control = nullptr;
+        uint32_t id = 0;
+        std::string name;
+        lc::ControlType type = lc::ControlTypeNone;
+        bool isArray = false;
+        size_t size = 0;        // Element count of fixed size arrays, 0 if dynamic
+        double min = 0;         // Numeric scalars only, NaN otherwise
+        double max = 0;
+        double def = 0;
+        std::vector<std::pair<int32_t, std::string>> enumerators;  // Enum controls only
+    };
+
+    ControlTable() = default;
+    explicit ControlTable(const lc::ControlInfoMap& infos);
+
+    const Entry* find(uint32_t id) const;
+    const Entry* find(std::string_view name) const;
+
+    /**
+     * Resolve a setting by id, or by name when its id is 0
+     */
+    const Entry* find(const ControlSetting& setting) const;
+
+    /**
+     * Entries ordered by id
+     */
+    const std::vector<Entry>& entries() const { return entries_; }
+
+    /**
+     * Convert setting values to the control's type: a scalar, the elements
+     * of an array control, or x, y, width, height for rectangles
+     * @return Empty value if the values do not fit the control
+     */
+    static lc::ControlValue toValue(const Entry& entry, const std::vector<double>& values);
+
+private:
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, size_t> byName_;
+};
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+namespace lcam {
+
+/**
+ * What a full delivery queue does with another frame
+ */
+enum class OverflowPolicy {
+    DropOldest,  // Keep the most recent frames, e.g. for live previews
+    DropNewest   // Keep what is queued, e.g. for recording a burst
+};
+
+/**
+ * Bounded FIFO of frames waiting for a slow consumer, so producers never
+ * wait on it. Not synchronised, the owner guards it.
+ */
+template<typename T>
+class DeliveryQueue {
+public:
+    DeliveryQueue(size_t capacity, OverflowPolicy policy) : capacity_(capacity ? capacity : 1), policy_(policy) {}
+
+    /**
+     * Queue an item, dropping one according to the policy when full
+     * @return false if the item itself was dropped
+     */
+    bool push(T item) {
+        if (items_.size() >= capacity_) {
+            dropped_++;
+            if (policy_ == OverflowPolicy::DropNewest) return false;
+            items_.pop_front();
+        }
+
+        items_.push_back(std::move(item));
+        return true;
+    }
+
+    /**
+     * @return false if the queue is empty
+     */
+    bool pop(T& item) {
+        if (items_.empty()) return false;
+
+        item = std::move(items_.front());
+        items_.pop_front();
+        popped_++;
+        return true;
+    }
+
+    /**
+     * Change the limits, dropping the oldest items over the new capacity
+     */
+    void configure(size_t capacity, OverflowPolicy policy) {
+        capacity_ = capacity ? capacity : 1;
+        policy_ = policy;
+
+        while (items_.size() > capacity_) {
+            items_.pop_front();
+            dropped_++;
+        }
+    }
+
+    size_t size() const { return items_.size(); }
+    size_t capacity() const { return capacity_; }
+    OverflowPolicy policy() const { return policy_; }
+    uint64_t dropped() const { return dropped_; }
+    uint64_t popped() const { return popped_; }
+
+private:
+    std::deque<T> items_;
+    size_t capacity_;
+    OverflowPolicy policy_;
+    uint64_t dropped_ = 0;
+    uint64_t popped_ = 0;
+};
+
+}
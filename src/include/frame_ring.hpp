@@ -0,0 +1,58 @@
+#pragma once
+
+#include "common.hpp"
+
+namespace lcam {
+
+/**
+ * Fixed slots of frames in memory shared with JavaScript workers, e.g. a
+ * SharedArrayBuffer. Frames are copied into the slots round robin; each
+ * slot is guarded by a seqlock whose version is odd while it is written.
+ *
+ * Layout, native endian, mirrored by lib/ring.ts:
+ *   0    int32   frames written, the Atomics.wait/notify word
+ *   4    int32   slot count
+ *   8    int32   slot size in bytes
+ *   12   int32   offset of the first slot's data
+ *   16   int32   last slot written
+ *   64 + 32 * i  slot header: int32 version, uint32 sequence,
+ *                uint32 stream id, uint32 bytes, uint64 timestamp at +16
+ *   data offset + slot size * i  slot data
+ */
+class FrameRing {
+public:
+    static constexpr size_t kHeaderBytes = 64;
+    static constexpr size_t kSlotHeaderBytes = 32;
+    static constexpr size_t kAlignment = 64;
+
+    /**
+     * Memory needed for a ring, slot sizes are rounded up to the alignment
+     */
+    static size_t requiredBytes(size_t slots, size_t frameBytes);
+
+    /**
+     * Lay out a ring over memory of at least requiredBytes()
+     */
+    FrameRing(uint8_t* memory, size_t slots, size_t frameBytes);
+
+    /**
+     * Copy a frame into the next slot. Single writer only.
+     * @return Slot written
+     */
+    uint32_t write(const Frame& frame);
+
+    size_t slots() const { return slots_; }
+
+private:
+    static size_t align(size_t bytes) { return (bytes + kAlignment - 1) / kAlignment * kAlignment; }
+
+    int32_t* word(size_t offset) const { return reinterpret_cast<int32_t*>(memory_ + offset); }
+
+    uint8_t* memory_;
+    size_t slots_;
+    size_t slotSize_;
+    size_t dataOffset_;
+    uint32_t next_ = 0;
+};
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "common.hpp"
+#include <deque>
+#include <mutex>
+
+namespace lcam {
+
+/**
+ * Two frames captured closest in time by different cameras
+ */
+struct FramePair {
+    Frame left;
+    Frame right;
+    int64_t skew;  // right.timestamp - left.timestamp in nanoseconds
+};
+
+using PairCallback = std::function<void(const FramePair& pair)>;
+
+/**
+ * Pairs frames from two sources by sensor timestamp.
+ *
+ * Frames are matched when their timestamps differ by at most the tolerance
+ * and neither has a closer candidate already queued on the other side.
+ * Frames that can no longer be matched are dropped and counted. Sources only
+ * need to deliver monotonically increasing timestamps, so the class can be
+ * driven by cameras or by synthetic sources alike.
+ */
+class FrameSynchronizer {
+public:
+    enum Side : size_t { LEFT = 0, RIGHT = 1 };
+
+    struct Stats {
+        uint64_t pairs = 0;
+        uint64_t droppedLeft = 0;
+        uint64_t droppedRight = 0;
+        int64_t lastSkew = 0;  // Nanoseconds
+    };
+
+    /**
+     * @param toleranceNs Maximum timestamp difference of a pair
+     * @param maxPending Frames kept per side while the other side lags behind
+     * @param callback Called for every matched pair, outside the internal lock
+     */
+    FrameSynchronizer(uint64_t toleranceNs, size_t maxPending, PairCallback callback);
+
+    /**
+     * Offer a frame from one side. Frames without an owner are copied, since
+     * their data is only valid for the duration of the frame callback.
+     */
+    void push(Side side, const Frame& frame);
+
+    /**
+     * Drop all queued frames
+     */
+    void reset();
+
+    Stats stats() const;
+
+private:
+    void drop(Side side);
+
+    const uint64_t toleranceNs_;
+    const size_t maxPending_;
+    PairCallback callback_;
+
+    mutable std::mutex mutex_;
+    std::deque<Frame> pending_[2];
+    Stats stats_;
+};
+
+}
@@ -31,39 +31,74 @@ public:
     void stop();
 
     /**
-     * Queue YUV frame for JPEG encoding
+     * Queue YUV frame for JPEG encoding. Never blocks: the frame is dropped
+     * and counted in framesDropped() when the queue is full.
      * @param yuvData YUV420 planar data
      * @param width Frame width
      * @param height Frame height
+     * @param stride Bytes per line of the Y plane
      * @param quality JPEG quality (1-100)
-     * @param timestamp Frame timestamp
-     * @param sequence Frame sequence number
+     * @param info Frame timestamp, sequence and stream id (data is ignored)
      * @param callback Called when encoding complete
      */
     void encode(const uint8_t* yuvData, uint32_t width, uint32_t height,
-                int quality, uint64_t timestamp, uint32_t sequence,
+                uint32_t stride, int quality, const Frame& info,
                 FrameCallback callback);
 
+    /**
+     * Number of frames encoded successfully since construction
+     */
+    uint64_t framesEncoded() const { return framesEncoded_; }
+
+    /**
+     * Number of frames TurboJPEG failed to encode
+     */
+    uint64_t encodeErrors() const { return encodeErrors_; }
+
+    /**
+     * Number of frames dropped because the queue was full
+     */
+    uint64_t framesDropped() const { return framesDropped_; }
+
+    /**
+     * Number of frames waiting to be encoded
+     */
+    size_t queueDepth() const;
+
+    /**
+     * Milliseconds the oldest waiting frame has been queued, 0 if empty
+     */
+    double oldestQueuedMs() const;
+
 private:
     struct Task {
         const uint8_t* data;
         uint32_t width;
         uint32_t height;
+        uint32_t stride;
         int quality;
-        uint64_t timestamp;
-        uint32_t sequence;
+        Frame info;
         FrameCallback callback;
         std::shared_ptr<std::vector<uint8_t>> dataOwner;  // Keeps YUV data alive during encoding
+        std::chrono::steady_clock::time_point queuedAt;
     };
 
     void workerThread();
 
+    /**
+     * Whether a frame fits the queue, counting it as dropped if not
+     */
+    bool hasRoom();
+
     tjhandle tjHandle_;               // TurboJPEG compressor instance
     std::thread worker_;              // Encoding thread
     std::queue<Task> queue_;          // Pending encode tasks
-    std::mutex mutex_;
+    mutable std::mutex mutex_;
     std::condition_variable cv_;
     std::atomic<bool> running_{false};
+    std::atomic<uint64_t> framesEncoded_{0};
+    std::atomic<uint64_t> encodeErrors_{0};
+    std::atomic<uint64_t> framesDropped_{0};
 
     std::vector<uint8_t> buffer_;     // Reusable output buffer
     const size_t maxQueueSize_;       // Configurable max queue size
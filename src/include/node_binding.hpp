@@ -2,6 +2,22 @@
 
 #include <napi.h>
 #include "camera_manager.hpp"
+#include "delivery_queue.hpp"
+#include "frame_ring.hpp"
+#include <map>
+#include <optional>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
+/**
+ * Per-environment addon state, so the addon can be loaded by the main
+ * thread and any number of worker threads at once
+ */
+struct AddonData {
+    Napi::FunctionReference camera;
+};
 
 /**
  * Node.js addon wrapper for camera functionality
@@ -12,22 +28,302 @@ public:
     NodeCamera(const Napi::CallbackInfo& info);
     ~NodeCamera();
 
+    /**
+     * Check whether a JS value wraps a NodeCamera
+     */
+    static bool IsInstance(const Napi::Value& value);
+
+    /**
+     * Native camera behind this wrapper, for other native consumers. Shared,
+     * since finalizers run in no fixed order at environment teardown and a
+     * consumer may detach from it after this wrapper is gone.
+     */
+    std::shared_ptr<lcam::CameraManager> manager() const { return camera_; }
+
+    /**
+     * Build a { data, timestamp, sequence, streamId, metadata } object. The
+     * Buffer keeps frame.owner alive; frames without an owner point into
+     * mapped camera memory.
+     * @param copy Copy the data into a Buffer V8 owns, which postMessage()
+     *        can transfer to another thread
+     */
+    static Napi::Object frameToObject(Napi::Env env, const lcam::Frame& frame, bool copy = false);
+
 private:
-    static Napi::FunctionReference constructor;
 
     // JavaScript method bindings
     Napi::Value Start(const Napi::CallbackInfo& info);
     Napi::Value Stop(const Napi::CallbackInfo& info);
+    Napi::Value Reconfigure(const Napi::CallbackInfo& info);
+    Napi::Value CaptureStill(const Napi::CallbackInfo& info);
+    Napi::Value Pause(const Napi::CallbackInfo& info);
+    Napi::Value Resume(const Napi::CallbackInfo& info);
     Napi::Value SetControls(const Napi::CallbackInfo& info);
+    Napi::Value ScheduleControls(const Napi::CallbackInfo& info);
+    Napi::Value Bracket(const Napi::CallbackInfo& info);
+    Napi::Value SetCrop(const Napi::CallbackInfo& info);
     Napi::Value GetControls(const Napi::CallbackInfo& info);
     Napi::Value GetCapabilities(const Napi::CallbackInfo& info);
+    Napi::Value GetStats(const Napi::CallbackInfo& info);
+    Napi::Value IsRunning(const Napi::CallbackInfo& info);
     Napi::Value On(const Napi::CallbackInfo& info);
+    Napi::Value Off(const Napi::CallbackInfo& info);
+    Napi::Value FrameLayout(const Napi::CallbackInfo& info);
+    Napi::Value AttachRing(const Napi::CallbackInfo& info);
+    Napi::Value DetachRing(const Napi::CallbackInfo& info);
+    Napi::Value NextFrame(const Napi::CallbackInfo& info);
+    Napi::Value Initialize(const Napi::CallbackInfo& info);
+    Napi::Value StartAsync(const Napi::CallbackInfo& info);
+    Napi::Value StopAsync(const Napi::CallbackInfo& info);
+    Napi::Value ReconfigureAsync(const Napi::CallbackInfo& info);
+
+    // Module-level functions
+    static Napi::Value ListCameras(const Napi::CallbackInfo& info);
 
-    // Helper methods for control conversion
+    // Helper methods for configuration and control conversion
+    lcam::CameraConfig parseConfig(const Napi::Object& config);
     lcam::Controls parseControls(const Napi::Object& obj);
     Napi::Object controlsToObject(Napi::Env env, const lcam::Controls& controls);
 
-    std::unique_ptr<lcam::CameraManager> camera_;
-    Napi::ThreadSafeFunction tsfn_;  // Thread-safe callback
-    bool hasEventHandler_ = false;
+    /**
+     * Start the camera with callbacks that post into the mailboxes. Safe to
+     * call off the JS thread.
+     */
+    bool startCamera();
+
+    /**
+     * Reject pending nextFrame() calls, e.g. when streaming stops
+     */
+    void cancelPulls(Napi::Env env);
+
+    /**
+     * Throw unless the camera is initialized. A deferred camera has no
+     * libcamera objects until initialize() resolves.
+     * @return false if an exception was thrown
+     */
+    bool checkInitialized(Napi::Env env);
+
+    /**
+     * Throw unless the camera is initialized and no async lifecycle
+     * operation is running. Every method reaching the camera uses it,
+     * reconfigureAsync() rebuilds streams and controls on the thread pool.
+     * @return false if an exception was thrown
+     */
+    bool checkIdle(Napi::Env env);
+
+    class LifecycleWorker;
+
+    /**
+     * Fill the Float64Array shared by all frame events of this camera
+     */
+    Napi::Float64Array metadataView(Napi::Env env, const lcam::FrameMetadata& metadata);
+
+    /**
+     * Frame or group waiting in a mailbox for the JS thread
+     */
+    struct Event {
+        lcam::StreamType streamType = lcam::StreamType::RAW;
+        lcam::Frame frame;
+        std::unique_ptr<lcam::FrameGroup> group;  // Group events only
+
+        uint64_t timestamp() const { return group ? group->timestamp : frame.timestamp; }
+    };
+
+    /**
+     * Events that get their own JS handler and thread-safe function. The
+     * catch-all 'frame' channel receives streams and errors without one.
+     */
+    enum Channel : size_t {
+        JpegChannel,
+        RgbChannel,
+        StillChannel,
+        GroupChannel,
+        FrameChannel,
+        ErrorChannel,
+        ChannelCount
+    };
+
+    struct Subscription {
+        Napi::ThreadSafeFunction tsfn;
+        bool active = false;
+        bool drainScheduled = false;  // A drain call is queued on tsfn
+        int64_t batchOpenedNs = 0;    // First frame waiting for a batch, 0 if none
+    };
+
+    static Channel channelOf(lcam::StreamType type);
+
+    /**
+     * Channel that handles events meant for the given one, ChannelCount if
+     * nobody listens. Caller holds mailboxMutex_.
+     */
+    Channel route(Channel channel) const;
+
+    /**
+     * Cheap check before any N-API work, without taking mailboxMutex_
+     */
+    bool subscribed(Channel channel) const {
+        const uint32_t mask = subscribed_.load(std::memory_order_relaxed);
+        return mask & ((1u << channel) | (1u << FrameChannel));
+    }
+
+    struct DeliveryLimits {
+        size_t queueSize = 4;
+        lcam::OverflowPolicy overflow = lcam::OverflowPolicy::DropOldest;
+    };
+
+    /**
+     * Events of one stream, or of all groups
+     */
+    struct Mailbox {
+        lcam::DeliveryQueue<std::unique_ptr<Event>> queue;
+        lcam::StreamType type;
+        Channel channel;
+    };
+
+    static constexpr uint32_t kGroupMailbox = UINT32_MAX;
+
+    /**
+     * Frames are emitted as one batch per stream once maxFrames are queued
+     * or the oldest waited maxDelayMs; maxFrames 0 emits every frame
+     */
+    struct BatchLimits {
+        uint32_t maxFrames = 0;
+        uint32_t maxDelayMs = 10;
+    };
+
+    /**
+     * Read the delivery queue limits of a configuration, applied to
+     * mailboxes that already exist as well
+     */
+    void parseDelivery(const Napi::Object& config);
+
+    /**
+     * Queue an event from a capture or encoder thread and make sure a drain
+     * is scheduled on the JS thread. Never blocks on JavaScript; with the
+     * encoders dropping on overflow, neither does anything upstream.
+     */
+    void post(uint32_t key, lcam::StreamType type, std::unique_ptr<Event> event);
+
+    /**
+     * Queue a drain call for a channel unless one is pending. Caller holds
+     * mailboxMutex_.
+     */
+    void scheduleDrain(Channel channel);
+
+    /**
+     * Flush batches that reached maxDelayMs without filling up
+     */
+    void batchFlushThread();
+
+    /**
+     * Emit everything queued for a channel, in capture order
+     */
+    void drain(Napi::Env env, Napi::Function callback, Channel channel);
+
+    /**
+     * Emit a group as an event object, or a frame as positional arguments
+     * (stream type, data, timestamp, sequence, stream id, metadata)
+     */
+    void emit(Napi::Env env, Napi::Function callback, std::unique_ptr<Event> event);
+
+    /**
+     * Emit frames of one stream with one call: a Buffer per frame, all other
+     * fields in shared typed arrays
+     */
+    void emitBatch(Napi::Env env, Napi::Function callback, std::vector<std::unique_ptr<Event>> frames);
+
+    /**
+     * Buffer over an event's frame that keeps the event alive until GC, or
+     * a transferable copy when transfers() says so
+     */
+    Napi::Buffer<uint8_t> wrapFrame(Napi::Env env, std::unique_ptr<Event> event) const;
+
+    /**
+     * Most recent frame of a pull-mode stream, waiting for nextFrame()
+     */
+    struct PullSlot {
+        lcam::StreamType type = lcam::StreamType::RAW;
+        std::unique_ptr<Event> latest;
+        size_t waiting = 0;      // nextFrame() promises not yet resolved
+        uint64_t taken = 0;
+        uint64_t replaced = 0;   // Frames overwritten before anyone asked
+    };
+
+    /**
+     * Keep a frame of a pull-mode stream as its latest and wake pending
+     * nextFrame() calls
+     * @return false if the stream pushes its frames
+     */
+    bool offer(lcam::StreamType type, const lcam::Frame& frame);
+
+    /**
+     * Resolve the nextFrame() promises of every stream with a frame
+     */
+    void resolvePulls(Napi::Env env);
+
+    std::shared_ptr<lcam::CameraManager> camera_;
+    Napi::Reference<Napi::Float64Array> metadataView_;  // Overwritten for every frame event
+    bool transferable_ = false;  // Copy JPEG and still frames into Buffers that postMessage() can transfer
+
+    /**
+     * Whether frames of a stream type get a transferable copy. RGB frames
+     * are too large to copy per frame on the JS thread; workers share them
+     * through a frame ring instead.
+     */
+    bool transfers(lcam::StreamType type) const { return transferable_ && type != lcam::StreamType::RGB; }
+
+    // Native cost of handing frames to JavaScript, JS handlers excluded.
+    // JS thread only.
+    uint64_t dispatchedFrames_ = 0;
+    uint64_t dispatchNs_ = 0;
+
+    // Async lifecycle, JS thread only
+    std::optional<lcam::CameraConfig> pendingConfig_;  // Waiting for initialize()
+    bool initialized_ = false;
+    bool busy_ = false;  // A LifecycleWorker is running
+
+    // Bounded delivery, keyed by stream id
+    std::map<uint32_t, Mailbox> mailboxes_;
+    DeliveryLimits deliveryDefaults_;
+    std::map<uint32_t, DeliveryLimits> deliveryLimits_;  // Streams with their own limits
+    std::mutex mailboxMutex_;
+
+    // JS handlers, guarded by mailboxMutex_
+    std::array<Subscription, ChannelCount> channels_;
+    std::atomic<uint32_t> subscribed_{0};  // Bit per active channel
+
+    // Cleared by the destructor. Calls still queued on a released TSFN run
+    // after it and check this before touching the camera. JS thread only.
+    std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
+
+    /**
+     * Frame ring in a SharedArrayBuffer, filled by a native frame listener
+     */
+    struct Ring {
+        std::unique_ptr<lcam::FrameRing> ring;
+        Napi::Reference<Napi::Uint8Array> memory;  // Keeps the shared memory alive
+        Napi::ThreadSafeFunction tsfn;             // Carries slot indices only
+        std::atomic<bool> signalPending{false};
+        uint32_t listenerId = 0;
+    };
+
+    void detachRing(uint32_t streamId);
+
+    // By stream id, JS thread only. A ring is deleted by its TSFN's
+    // finalizer, after the last pending signal ran.
+    std::map<uint32_t, Ring*> rings_;
+
+    // Pull mode, slots by stream id guarded by mailboxMutex_
+    std::map<uint32_t, PullSlot> pulls_;
+    std::atomic<bool> pulling_{false};  // Any stream in pull mode
+    std::map<uint32_t, std::vector<Napi::Promise::Deferred>> pullWaiters_;  // JS thread only
+    Napi::ThreadSafeFunction pullTsfn_;  // Created by the first nextFrame()
+    bool pullTsfnActive_ = false;
+    bool pullScheduled_ = false;
+
+    // Batched delivery, limits guarded by mailboxMutex_
+    BatchLimits batch_;
+    std::thread batchFlusher_;
+    std::condition_variable batchCv_;
+    bool flusherRunning_ = false;
 };
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "common.hpp"
+#include <mutex>
+
+namespace lcam {
+
+/**
+ * Camera description available without acquiring the device
+ */
+struct CameraInfo {
+    std::string id;          // Stable libcamera id, usable as CameraConfig::cameraId
+    std::string model;       // Sensor model, e.g. "imx708"
+    std::string location;    // "front", "back", "external" or "unknown"
+    uint32_t pixelArrayWidth = 0;
+    uint32_t pixelArrayHeight = 0;
+};
+
+/**
+ * Process-wide, reference counted libcamera manager.
+ *
+ * libcamera allows a single lc::CameraManager per process, so every camera
+ * instance shares the one returned here. It is started on first use and
+ * stopped when the last reference is dropped.
+ */
+class SharedCameraManager {
+public:
+    /**
+     * Get the shared manager, starting it if necessary
+     * @return nullptr if the manager failed to start
+     */
+    static std::shared_ptr<lc::CameraManager> acquire();
+
+    /**
+     * Enumerate connected cameras without acquiring them. Starts and stops
+     * the manager synchronously unless a camera holds it, which includes
+     * device enumeration and IPA loading.
+     */
+    static std::vector<CameraInfo> listCameras();
+
+private:
+    static std::mutex mutex_;
+    static std::weak_ptr<lc::CameraManager> instance_;
+};
+
+}
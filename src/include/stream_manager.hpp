@@ -12,14 +12,30 @@ namespace lcam {
  */
 class StreamManager {
 public:
+    static constexpr uint32_t kRawStreamId = UINT32_MAX;
+
+    /**
+     * Per-stream geometry resolved after validation
+     */
+    struct StreamInfo {
+        StreamType type;
+        uint32_t id;      // Index into the user stream list, kRawStreamId for RAW
+        uint32_t width;
+        uint32_t height;
+        uint32_t stride;  // Bytes per line of the first plane
+    };
+
     StreamManager(std::shared_ptr<lc::Camera> camera);
     ~StreamManager();
 
     /**
      * Configure streams based on requested types and resolutions
+     * @param heldRequests Extra buffers and requests for requests kept back
+     *        from capture, e.g. by a zero-shutter-lag ring
      */
     bool configure(const std::optional<StreamConfig>& rawStream,
-                   const std::vector<StreamConfig>& configs);
+                   const std::vector<StreamConfig>& configs,
+                   size_t heldRequests = 0);
 
     /**
      * Allocate frame buffers and create capture requests
@@ -41,6 +57,18 @@ public:
      */
     StreamType getStreamType(const lc::Stream* stream) const;
 
+    /**
+     * Get resolved geometry for a given libcamera stream
+     * @return nullptr for unknown streams
+     */
+    const StreamInfo* getStreamInfo(const lc::Stream* stream) const;
+
+    /**
+     * All configured streams with their resolved geometry, empty after a
+     * failed configure()
+     */
+    const std::map<const lc::Stream*, StreamInfo>& streams() const { return streamInfos_; }
+
     /**
      * Get buffer at index for a stream
      */
@@ -56,10 +84,6 @@ public:
      */
     size_t getMappedSize(lc::FrameBuffer* buffer) const;
 
-    // JPEG stream dimensions for encoder
-    uint32_t getJpegWidth() const { return jpegWidth_; }
-    uint32_t getJpegHeight() const { return jpegHeight_; }
-
     const std::vector<std::unique_ptr<lc::Request>>& requests() const { return requests_; }
 
 private:
@@ -67,8 +91,8 @@ private:
     std::unique_ptr<lc::CameraConfiguration> config_;
     std::unique_ptr<lc::FrameBufferAllocator> allocator_;
 
-    // Stream to type mapping
-    std::map<const lc::Stream*, StreamType> streamTypes_;
+    // Stream to type and geometry mapping
+    std::map<const lc::Stream*, StreamInfo> streamInfos_;
 
     // Stream to buffer list mapping
     std::map<const lc::Stream*, std::vector<lc::FrameBuffer*>> streamBuffers_;
@@ -85,14 +109,14 @@ private:
     // Pre-allocated capture requests
     std::vector<std::unique_ptr<lc::Request>> requests_;
 
-    // Cached JPEG dimensions
-    uint32_t jpegWidth_ = 0;
-    uint32_t jpegHeight_ = 0;
+    // Buffers per stream, which is also the number of requests
+    static constexpr size_t kBaseBufferCount = 6;
+    size_t bufferCount_ = kBaseBufferCount;
 
     /**
      * Memory-map a buffer for zero-copy access
      */
-    bool mapBuffer(lc::FrameBuffer* buffer, StreamType type, uint32_t width, uint32_t height);
+    bool mapBuffer(lc::FrameBuffer* buffer, const StreamInfo& info);
 };
 
 }
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <napi.h>
+#include "camera_manager.hpp"
+#include "frame_synchronizer.hpp"
+#include <atomic>
+
+/**
+ * Node.js wrapper pairing frames of two cameras by sensor timestamp
+ */
+class NodeFrameSync : public Napi::ObjectWrap<NodeFrameSync> {
+public:
+    static void Init(Napi::Env env, Napi::Object exports);
+    NodeFrameSync(const Napi::CallbackInfo& info);
+    ~NodeFrameSync();
+
+private:
+    // JavaScript method bindings
+    Napi::Value Push(const Napi::CallbackInfo& info);
+    Napi::Value GetStats(const Napi::CallbackInfo& info);
+    Napi::Value Close(const Napi::CallbackInfo& info);
+
+    /**
+     * Detach from both cameras and release the JS callback
+     */
+    void close();
+
+    // Pairs waiting for the JS thread. push() pairs on the JS thread and
+    // camera threads must not wait on it, so pairs over this are dropped.
+    static constexpr size_t kPairQueueSize = 4;
+
+    std::unique_ptr<lcam::FrameSynchronizer> sync_;
+    Napi::ThreadSafeFunction tsfn_;
+    std::shared_ptr<std::atomic<uint64_t>> pairsDropped_ = std::make_shared<std::atomic<uint64_t>>(0);
+
+    // Cameras we listen to. The wrappers are kept alive through JS
+    // references, the managers through shared ownership in case a wrapper
+    // is finalized first at environment teardown.
+    std::shared_ptr<lcam::CameraManager> cameras_[2];
+    uint32_t listenerIds_[2] = {0, 0};
+    Napi::ObjectReference cameraRefs_[2];
+    bool open_ = false;
+};
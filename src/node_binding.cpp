@@ -1,22 +1,84 @@
 #include "node_binding.hpp"
+#include "shared_camera_manager.hpp"
+#include "sync_binding.hpp"
 #include <map>
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <chrono>
+#include <functional>
+
+static const char *streamTypeName(lcam::StreamType type) {
+    switch (type) {
+        case lcam::StreamType::JPEG: return "jpeg";
+        case lcam::StreamType::RGB: return "rgb";
+        case lcam::StreamType::STILL: return "still";
+        case lcam::StreamType::RAW: break;
+    }
+    return "raw";
+}
+
+static const char *controlTypeName(lc::ControlType type) {
+    switch (type) {
+        case lc::ControlTypeBool: return "bool";
+        case lc::ControlTypeByte: return "byte";
+        case lc::ControlTypeInteger32: return "int32";
+        case lc::ControlTypeInteger64: return "int64";
+        case lc::ControlTypeFloat: return "float";
+        case lc::ControlTypeString: return "string";
+        case lc::ControlTypeRectangle: return "rectangle";
+        case lc::ControlTypeSize: return "size";
+        default: return "unknown";
+    }
+}
 
-Napi::FunctionReference NodeCamera::constructor;
+// Matches ErrorCodes in lib/types.ts
+static const char *errorCodeName(lcam::ErrorCode code) {
+    switch (code) {
+        case lcam::ErrorCode::StartFailed: return "START_FAILED";
+        case lcam::ErrorCode::Stalled: return "STALLED";
+        case lcam::ErrorCode::RecoveryFailed: return "RECOVERY_FAILED";
+        case lcam::ErrorCode::ReconfigureFailed: return "RECONFIGURE_FAILED";
+        case lcam::ErrorCode::Unknown: break;
+    }
+    return "UNKNOWN";
+}
 
 Napi::Object NodeCamera::Init(Napi::Env env, Napi::Object exports) {
     Napi::Function func = DefineClass(env, "Camera", {
         InstanceMethod("start", &NodeCamera::Start),
         InstanceMethod("stop", &NodeCamera::Stop),
+        InstanceMethod("reconfigure", &NodeCamera::Reconfigure),
+        InstanceMethod("captureStill", &NodeCamera::CaptureStill),
+        InstanceMethod("pause", &NodeCamera::Pause),
+        InstanceMethod("resume", &NodeCamera::Resume),
         InstanceMethod("setControls", &NodeCamera::SetControls),
+        InstanceMethod("scheduleControls", &NodeCamera::ScheduleControls),
+        InstanceMethod("bracket", &NodeCamera::Bracket),
+        InstanceMethod("setCrop", &NodeCamera::SetCrop),
         InstanceMethod("getControls", &NodeCamera::GetControls),
         InstanceMethod("getCapabilities", &NodeCamera::GetCapabilities),
+        InstanceMethod("getStats", &NodeCamera::GetStats),
+        InstanceMethod("isRunning", &NodeCamera::IsRunning),
         InstanceMethod("on", &NodeCamera::On),
+        InstanceMethod("off", &NodeCamera::Off),
+        InstanceMethod("frameLayout", &NodeCamera::FrameLayout),
+        InstanceMethod("attachRing", &NodeCamera::AttachRing),
+        InstanceMethod("detachRing", &NodeCamera::DetachRing),
+        InstanceMethod("nextFrame", &NodeCamera::NextFrame),
+        InstanceMethod("initialize", &NodeCamera::Initialize),
+        InstanceMethod("startAsync", &NodeCamera::StartAsync),
+        InstanceMethod("stopAsync", &NodeCamera::StopAsync),
+        InstanceMethod("reconfigureAsync", &NodeCamera::ReconfigureAsync),
     });
 
-    constructor = Napi::Persistent(func);
-    constructor.SuppressDestruct();
+    // Deleted with the environment, e.g. when a worker exits
+    auto *data = new AddonData();
+    data->camera = Napi::Persistent(func);
+    env.SetInstanceData(data);
 
     exports.Set("Camera", func);
+    exports.Set("listCameras", Napi::Function::New(env, &NodeCamera::ListCameras, "listCameras"));
 
     // Export control enum constants
     const auto controls = Napi::Object::New(env);
@@ -52,9 +114,51 @@ Napi::Object NodeCamera::Init(Napi::Env env, Napi::Object exports) {
 
     exports.Set("controls", controls);
 
+    NodeFrameSync::Init(env, exports);
+
     return exports;
 }
 
+bool NodeCamera::IsInstance(const Napi::Value &value) {
+    const auto *data = value.Env().GetInstanceData<AddonData>();
+    return data && value.IsObject() && value.As<Napi::Object>().InstanceOf(data->camera.Value());
+}
+
+Napi::Object NodeCamera::frameToObject(Napi::Env env, const lcam::Frame &frame, bool copy) {
+    auto buffer = copy ? Napi::Buffer<uint8_t>::Copy(env, frame.data.data(), frame.data.size())
+                       : Napi::Buffer<uint8_t>::New(
+                             env,
+                             const_cast<uint8_t *>(frame.data.data()),
+                             frame.data.size(),
+                             [](Napi::Env env, uint8_t *finalizeData, std::shared_ptr<void> *hint) {
+                                 delete hint;  // Release the frame when the buffer is GC'd
+                             },
+                             new std::shared_ptr<void>(frame.owner));
+
+    auto frameObj = Napi::Object::New(env);
+    frameObj.Set("data", buffer);
+    frameObj.Set("timestamp", Napi::BigInt::New(env, frame.timestamp));
+    frameObj.Set("sequence", frame.sequence);
+    frameObj.Set("streamId", frame.streamId);
+
+    // Paired frames are kept together, so each gets its own copy
+    auto metadata = Napi::Float64Array::New(env, lcam::FrameMetadata::FieldCount);
+    std::copy(frame.metadata.values.begin(), frame.metadata.values.end(), metadata.Data());
+    frameObj.Set("metadata", metadata);
+
+    return frameObj;
+}
+
+Napi::Float64Array NodeCamera::metadataView(Napi::Env env, const lcam::FrameMetadata &metadata) {
+    if (metadataView_.IsEmpty()) {
+        metadataView_ = Napi::Persistent(Napi::Float64Array::New(env, lcam::FrameMetadata::FieldCount));
+    }
+
+    auto view = metadataView_.Value();
+    std::copy(metadata.values.begin(), metadata.values.end(), view.Data());
+    return view;
+}
+
 NodeCamera::NodeCamera(const Napi::CallbackInfo &info)
     : Napi::ObjectWrap<NodeCamera>(info) {
     Napi::Env env = info.Env();
@@ -64,74 +168,86 @@ NodeCamera::NodeCamera(const Napi::CallbackInfo &info)
         return;
     }
 
-    auto config = info[0].As<Napi::Object>();
-    lcam::CameraConfig cameraConfig;
+    const auto cameraConfig = parseConfig(info[0].As<Napi::Object>());
+    parseDelivery(info[0].As<Napi::Object>());
 
-    // Parse optional RAW stream configuration
-    if (config.Has("rawStream")) {
-        auto rawStreamObj = config.Get("rawStream").As<Napi::Object>();
-        lcam::StreamConfig rawStream;
-        rawStream.type = lcam::StreamType::RAW;
+    camera_ = std::make_shared<lcam::CameraManager>();
 
-        if (rawStreamObj.Has("width")) {
-            rawStream.width = rawStreamObj.Get("width").As<Napi::Number>().Uint32Value();
-        } else {
-            rawStream.width = 2304;  // Default sensor resolution
-        }
-
-        if (rawStreamObj.Has("height")) {
-            rawStream.height = rawStreamObj.Get("height").As<Napi::Number>().Uint32Value();
-        } else {
-            rawStream.height = 1296;  // Default sensor resolution
-        }
-
-        cameraConfig.rawStream = rawStream;
+    // Deferred, initialize() does it on the thread pool
+    if (info[1].ToBoolean().Value()) {
+        pendingConfig_ = cameraConfig;
+        return;
     }
 
-    // Parse stream configuration
-    if (config.Has("streams")) {
-        const auto streams = config.Get("streams").As<Napi::Array>();
-
-        for (uint32_t i = 0; i < streams.Length(); ++i) {
-            auto streamObj = streams.Get(i).As<Napi::Object>();
-            auto typeStr = streamObj.Get("type").As<Napi::String>().Utf8Value();
-
-            lcam::StreamConfig sc;
+    if (!camera_->initialize(cameraConfig)) {
+        Napi::Error::New(env, "Failed to initialize camera").ThrowAsJavaScriptException();
+        return;
+    }
+    initialized_ = true;
+}
 
-            if (typeStr == "jpeg") {
-                sc.type = lcam::StreamType::JPEG;
-            } else if (typeStr == "rgb") {
-                sc.type = lcam::StreamType::RGB;
-            } else {
-                continue;  // Skip unknown types
-            }
+NodeCamera::~NodeCamera() {
+    *alive_ = false;
+    if (camera_ && initialized_) camera_->stop();
 
-            if (streamObj.Has("width")) sc.width = streamObj.Get("width").As<Napi::Number>().Uint32Value();
-            if (streamObj.Has("height")) sc.height = streamObj.Get("height").As<Napi::Number>().Uint32Value();
+    while (!rings_.empty()) {
+        detachRing(rings_.begin()->first);
+    }
 
-            cameraConfig.streams.push_back(sc);
-        }
+    {
+        std::lock_guard lock(mailboxMutex_);
+        flusherRunning_ = false;
     }
+    batchCv_.notify_one();
+    if (batchFlusher_.joinable()) batchFlusher_.join();
 
-    // Parse initial control values
-    if (config.Has("controls")) {
-        cameraConfig.initialControls = parseControls(config.Get("controls").As<Napi::Object>());
+    std::lock_guard lock(mailboxMutex_);
+    for (auto &channel : channels_) {
+        if (channel.active) channel.tsfn.Release();
     }
+    if (pullTsfnActive_) pullTsfn_.Release();
+}
 
-    // Parse JPEG encoder queue size
-    if (config.Has("jpegEncoderQueueSize")) {
-        cameraConfig.jpegEncoderQueueSize = config.Get("jpegEncoderQueueSize").As<Napi::Number>().Uint32Value();
+static int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Frames without an owner point into a camera buffer that is requeued as
+ * soon as the callback returns, so anything kept past it gets a copy
+ */
+static lcam::Frame ownedFrame(const lcam::Frame &frame) {
+    if (frame.owner) return frame;
+
+    lcam::Frame owned = frame;
+    auto copy = std::make_shared<std::vector<uint8_t>>(frame.data.begin(), frame.data.end());
+    owned.data = std::span<const uint8_t>(copy->data(), copy->size());
+    owned.owner = std::move(copy);
+    return owned;
+}
+
+static std::optional<size_t> channelByName(const std::string &name) {
+    static const char *names[] = {"jpeg", "rgb", "still", "group", "frame", "error"};
+    for (size_t i = 0; i < std::size(names); i++) {
+        if (name == names[i]) return i;
     }
+    return std::nullopt;
+}
 
-    camera_ = std::make_unique<lcam::CameraManager>();
-    if (!camera_->initialize(cameraConfig)) {
-        Napi::Error::New(env, "Failed to initialize camera").ThrowAsJavaScriptException();
+NodeCamera::Channel NodeCamera::channelOf(lcam::StreamType type) {
+    switch (type) {
+        case lcam::StreamType::JPEG: return JpegChannel;
+        case lcam::StreamType::RGB: return RgbChannel;
+        case lcam::StreamType::STILL: return StillChannel;
+        case lcam::StreamType::RAW: break;
     }
+    return FrameChannel;
 }
 
-NodeCamera::~NodeCamera() {
-    if (camera_) camera_->stop();
-    if (hasEventHandler_) tsfn_.Release();
+NodeCamera::Channel NodeCamera::route(Channel channel) const {
+    if (channels_[channel].active) return channel;
+    return channels_[FrameChannel].active ? FrameChannel : ChannelCount;
 }
 
 Napi::Value NodeCamera::On(const Napi::CallbackInfo &info) {
@@ -142,104 +258,655 @@ Napi::Value NodeCamera::On(const Napi::CallbackInfo &info) {
         return env.Undefined();
     }
 
-    auto event = info[0].As<Napi::String>().Utf8Value();
+    const auto event = info[0].As<Napi::String>().Utf8Value();
+    const auto index = channelByName(event);
+    if (!index) {
+        Napi::TypeError::New(env, "Unknown event '" + event + "'").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    std::lock_guard lock(mailboxMutex_);
+    auto &channel = channels_[*index];
+    if (channel.active) channel.tsfn.Release();
+
+    // Unlimited queue: frames wait in the bounded mailboxes and only drain
+    // requests and errors go through it
+    channel.tsfn = Napi::ThreadSafeFunction::New(
+        env,
+        info[1].As<Napi::Function>(),
+        "camera_" + event,
+        0,
+        1   // Single thread
+    );
+    channel.active = true;
+    channel.drainScheduled = false;
+    subscribed_.fetch_or(1u << *index, std::memory_order_relaxed);
 
-    if (event == "frame" || event == "error") {
-        if (hasEventHandler_) tsfn_.Release();
+    return env.Undefined();
+}
 
-        // Create thread-safe function for callbacks
-        tsfn_ = Napi::ThreadSafeFunction::New(
-            env,
-            info[1].As<Napi::Function>(),
-            "camera_events",
-            4,  // Unlimited queue
-            1   // Single thread
-        );
-        hasEventHandler_ = true;
+Napi::Value NodeCamera::Off(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    if (!info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected event name").ThrowAsJavaScriptException();
+        return env.Undefined();
     }
 
+    const auto index = channelByName(info[0].As<Napi::String>().Utf8Value());
+    if (!index) return env.Undefined();
+
+    // Frames already queued for it go to the catch-all channel, if any
+    std::lock_guard lock(mailboxMutex_);
+    auto &channel = channels_[*index];
+    if (channel.active) channel.tsfn.Release();
+    channel.active = false;
+    channel.drainScheduled = false;
+    subscribed_.fetch_and(~(1u << *index), std::memory_order_relaxed);
+
     return env.Undefined();
 }
 
 Napi::Value NodeCamera::Start(const Napi::CallbackInfo &info) {
     const auto env = info.Env();
-    if (!hasEventHandler_) {
+    if (!checkIdle(env)) return env.Undefined();
+    if (!subscribed_.load(std::memory_order_relaxed)) {
         Napi::Error::New(env, "Event handler not set").ThrowAsJavaScriptException();
         return env.Undefined();
     }
 
-    struct EventData {
-        enum Type { FRAME, ERROR } type;
-
-        lcam::StreamType streamType;
-        lcam::Frame frame;
-        std::string error;
-    };
+    return Napi::Boolean::New(env, startCamera());
+}
 
-    const bool success = camera_->start(
+bool NodeCamera::startCamera() {
+    return camera_->start(
         // Frame callback
         [this](lcam::StreamType type, const lcam::Frame &frame) {
-            auto *data = new EventData{
-                EventData::FRAME,
-                type,
-                frame,
-                ""
-            };
+            if (offer(type, frame) || !subscribed(channelOf(type))) return;
 
-            tsfn_.BlockingCall(data, [](Napi::Env env, Napi::Function cb, EventData *data) {
-                auto event = Napi::Object::New(env);
-                event.Set("type", "frame");
-                event.Set("stream", data->streamType == lcam::StreamType::JPEG ? "jpeg" : "rgb");
-
-                // Create zero-copy buffer
-                auto buffer = Napi::Buffer<uint8_t>::New(
-                    env,
-                    const_cast<uint8_t *>(data->frame.data.data()),
-                    data->frame.data.size(),
-                    [](Napi::Env env, uint8_t *finalizeData, EventData *hint) {
-                        delete hint;  // Cleanup when buffer is GC'd
-                    },
-                    data
-                );
-
-                auto frameObj = Napi::Object::New(env);
-                frameObj.Set("data", buffer);
-                frameObj.Set("timestamp", Napi::BigInt::New(env, data->frame.timestamp));
-                frameObj.Set("sequence", data->frame.sequence);
-
-                event.Set("frame", frameObj);
-                cb.Call({event});
-            });
+            auto event = std::make_unique<Event>();
+            event->streamType = type;
+            event->frame = ownedFrame(frame);
+            post(frame.streamId, type, std::move(event));
         },
-        // Error callback
-        [this](const std::string &error) {
-            auto *data = new EventData{
-                EventData::ERROR,
-                lcam::StreamType::RAW,
-                {},
-                error
-            };
-
-            tsfn_.BlockingCall(data, [](Napi::Env env, Napi::Function cb, EventData *data) {
+        // Error callback, errors bypass the mailboxes on their own channel
+        // and are never dropped
+        [this](const lcam::CameraError &error) {
+            std::lock_guard lock(mailboxMutex_);
+            const Channel channel = route(ErrorChannel);
+            if (channel == ChannelCount) return;
+
+            auto *data = new lcam::CameraError(error);
+            const auto status = channels_[channel].tsfn.NonBlockingCall(data, [](Napi::Env env, Napi::Function cb, lcam::CameraError *data) {
                 auto event = Napi::Object::New(env);
                 event.Set("type", "error");
-                event.Set("error", data->error);
+                event.Set("error", data->message);
+                event.Set("code", errorCodeName(data->code));
+                event.Set("stalledMs", data->stalledMs);
+                event.Set("recovering", data->recovering);
+                event.Set("streamId", data->streamId);
                 cb.Call({event});
                 delete data;
             });
+            if (status != napi_ok) delete data;
+        },
+        // Group callback, only used with groupedDelivery
+        [this](const lcam::FrameGroup &group) {
+            if (!subscribed(GroupChannel)) return;
+
+            auto event = std::make_unique<Event>();
+            event->group = std::make_unique<lcam::FrameGroup>(group);
+            for (auto &[type, frame] : event->group->frames) frame = ownedFrame(frame);
+            post(kGroupMailbox, lcam::StreamType::RAW, std::move(event));
+        }
+    );
+}
+
+bool NodeCamera::checkInitialized(Napi::Env env) {
+    if (initialized_) return true;
+
+    Napi::Error::New(env, "Camera is not initialized").ThrowAsJavaScriptException();
+    return false;
+}
+
+bool NodeCamera::checkIdle(Napi::Env env) {
+    if (!checkInitialized(env)) return false;
+    if (!busy_) return true;
+
+    Napi::Error::New(env, "Camera is busy with a start, stop or reconfigure").ThrowAsJavaScriptException();
+    return false;
+}
+
+/**
+ * Runs a lifecycle operation on the libuv thread pool, so mmap, ioctls and
+ * thread joins stay off the event loop, and settles a Promise with the
+ * timing of each phase
+ */
+class NodeCamera::LifecycleWorker : public Napi::AsyncWorker {
+public:
+    using Operation = std::function<bool()>;
+    using Completion = std::function<void(Napi::Env, bool ok)>;
+
+    /**
+     * @param firstFrameTimeoutMs Also wait for the first frame, 0 to skip
+     * @param done Runs on the JS thread before the Promise settles
+     */
+    LifecycleWorker(Napi::Env env, NodeCamera *camera, Operation operation,
+                    uint32_t firstFrameTimeoutMs = 0, Completion done = nullptr)
+        : Napi::AsyncWorker(env, "camera_lifecycle"),
+          camera_(camera),
+          self_(Napi::Persistent(camera->Value())),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          operation_(std::move(operation)),
+          done_(std::move(done)),
+          firstFrameTimeoutMs_(firstFrameTimeoutMs) {
+        camera_->busy_ = true;
+    }
+
+    Napi::Promise Promise() const { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        const int64_t mark = nowNs();
+        if (!operation_()) {
+            const auto error = camera_->camera_->lastError();
+            SetError(error.empty() ? "Camera operation failed" : error);
+            return;
+        }
+
+        if (firstFrameTimeoutMs_) firstFrame_ = camera_->camera_->waitForFirstFrame(firstFrameTimeoutMs_);
+        timings_ = camera_->camera_->getTimings();
+        totalMs_ = static_cast<double>(nowNs() - mark) / 1e6;
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        finish(env, true);
+
+        auto result = Napi::Object::New(env);
+        result.Set("managerStartMs", timings_.managerStartMs);
+        result.Set("acquireMs", timings_.acquireMs);
+        result.Set("configureMs", timings_.configureMs);
+        result.Set("allocateMs", timings_.allocateMs);
+        result.Set("startMs", timings_.startMs);
+        result.Set("firstFrameMs", firstFrame_ ? Napi::Value(Napi::Number::New(env, timings_.firstFrameMs)) : env.Null());
+        result.Set("stopMs", timings_.stopMs);
+        result.Set("totalMs", totalMs_);
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error &error) override {
+        finish(Env(), false);
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    void finish(Napi::Env env, bool ok) {
+        camera_->busy_ = false;
+        if (ok) {
+            for (const auto &[id, waiters] : camera_->pullWaiters_) {
+                if (!waiters.empty()) camera_->camera_->requestFrame(id);
+            }
+        }
+        if (done_) done_(env, ok);
+    }
+
+    NodeCamera *camera_;
+    Napi::ObjectReference self_;  // Keeps the camera alive while the operation runs
+    Napi::Promise::Deferred deferred_;
+    Operation operation_;
+    Completion done_;
+    uint32_t firstFrameTimeoutMs_;
+    bool firstFrame_ = false;
+    lcam::LifecycleTimings timings_;
+    double totalMs_ = 0;
+};
+
+Napi::Value NodeCamera::Initialize(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!pendingConfig_ || busy_) {
+        Napi::Error::New(env, busy_ ? "Camera is already initializing" : "Camera is already initialized")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto *worker = new LifecycleWorker(
+        env,
+        this,
+        [this, config = *pendingConfig_] { return camera_->initialize(config); },
+        0,
+        [this](Napi::Env, bool ok) {
+            if (!ok) return;
+            pendingConfig_.reset();
+            initialized_ = true;
+        }
+    );
+    worker->Queue();
+    return worker->Promise();
+}
+
+Napi::Value NodeCamera::StartAsync(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+    if (!subscribed_.load(std::memory_order_relaxed)) {
+        Napi::Error::New(env, "Event handler not set").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    const uint32_t firstFrameTimeoutMs = info[0].IsNumber() ? info[0].As<Napi::Number>().Uint32Value() : 2000;
+    auto *worker = new LifecycleWorker(env, this, [this] { return startCamera(); }, firstFrameTimeoutMs);
+    worker->Queue();
+    return worker->Promise();
+}
+
+Napi::Value NodeCamera::StopAsync(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+
+    auto *worker = new LifecycleWorker(
+        env,
+        this,
+        [this] {
+            camera_->stop();
+            return true;
+        },
+        0,
+        [this](Napi::Env env, bool) { cancelPulls(env); }
+    );
+    worker->Queue();
+    return worker->Promise();
+}
+
+Napi::Value NodeCamera::ReconfigureAsync(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+
+    if (!info[0].IsObject()) {
+        Napi::TypeError::New(env, "Configuration object expected").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto cameraConfig = parseConfig(info[0].As<Napi::Object>());
+    parseDelivery(info[0].As<Napi::Object>());
+    const uint32_t firstFrameTimeoutMs = info[1].IsNumber() ? info[1].As<Napi::Number>().Uint32Value() : 2000;
+
+    auto *worker = new LifecycleWorker(env, this, [this, config = std::move(cameraConfig)] {
+        return camera_->reconfigure(config);
+    }, firstFrameTimeoutMs);
+    worker->Queue();
+    return worker->Promise();
+}
+
+void NodeCamera::post(uint32_t key, lcam::StreamType type, std::unique_ptr<Event> event) {
+    std::lock_guard lock(mailboxMutex_);
+
+    auto it = mailboxes_.find(key);
+    if (it == mailboxes_.end()) {
+        auto limits = deliveryLimits_.find(key);
+        const auto &[queueSize, overflow] = limits != deliveryLimits_.end() ? limits->second : deliveryDefaults_;
+        const Channel channel = key == kGroupMailbox ? GroupChannel : channelOf(type);
+        it = mailboxes_.emplace(key, Mailbox{{queueSize, overflow}, type, channel}).first;
+    }
+
+    // Unsubscribed since the caller checked
+    const Channel channel = route(it->second.channel);
+    if (channel == ChannelCount) return;
+
+    // A dropped event releases its frame right here
+    it->second.queue.push(std::move(event));
+
+    // Frames wait for a full batch or the flusher's deadline, groups are
+    // never held back
+    if (batch_.maxFrames && key != kGroupMailbox) {
+        auto &subscription = channels_[channel];
+        if (!subscription.batchOpenedNs) {
+            subscription.batchOpenedNs = nowNs();
+            batchCv_.notify_one();
+        }
+        if (it->second.queue.size() < batch_.maxFrames) return;
+    }
+
+    scheduleDrain(channel);
+}
+
+void NodeCamera::scheduleDrain(Channel channel) {
+    // At most one drain is pending per channel, so the TSFN queue never
+    // fills up and this never blocks
+    auto &subscription = channels_[channel];
+    subscription.batchOpenedNs = 0;
+    if (subscription.drainScheduled) return;
+
+    subscription.drainScheduled = subscription.tsfn.NonBlockingCall(
+        [this, alive = alive_, channel](Napi::Env env, Napi::Function cb) {
+            if (*alive) drain(env, cb, channel);
+        }) == napi_ok;
+}
+
+void NodeCamera::batchFlushThread() {
+    std::unique_lock lock(mailboxMutex_);
+
+    while (flusherRunning_) {
+        const int64_t now = nowNs();
+        const int64_t delayNs = static_cast<int64_t>(batch_.maxDelayMs) * 1000000;
+        int64_t next = 0;
+
+        for (size_t i = 0; i < ChannelCount; i++) {
+            const int64_t opened = channels_[i].batchOpenedNs;
+            if (!opened || !channels_[i].active) continue;
+
+            if (opened + delayNs <= now) {
+                scheduleDrain(static_cast<Channel>(i));
+            } else if (!next || opened + delayNs < next) {
+                next = opened + delayNs;
+            }
+        }
+
+        if (next) {
+            batchCv_.wait_for(lock, std::chrono::nanoseconds(next - now));
+        } else {
+            batchCv_.wait(lock);
+        }
+    }
+}
+
+void NodeCamera::drain(Napi::Env env, Napi::Function callback, Channel channel) {
+    std::vector<std::vector<std::unique_ptr<Event>>> batches;
+    {
+        std::lock_guard lock(mailboxMutex_);
+
+        // Anything posted from here on schedules another drain
+        channels_[channel].drainScheduled = false;
+        channels_[channel].batchOpenedNs = 0;
+
+        for (auto &[key, mailbox] : mailboxes_) {
+            if (route(mailbox.channel) != channel || !mailbox.queue.size()) continue;
+
+            // Unbatched, every event is a batch of its own
+            const bool batched = batch_.maxFrames && key != kGroupMailbox;
+            if (batched) batches.emplace_back();
+
+            std::unique_ptr<Event> event;
+            while (mailbox.queue.pop(event)) {
+                if (!batched) batches.emplace_back();
+                batches.back().push_back(std::move(event));
+            }
+        }
+    }
+
+    // Mailboxes were emptied one after another, restore capture order
+    std::stable_sort(batches.begin(), batches.end(), [](const auto &a, const auto &b) {
+        return a.front()->timestamp() < b.front()->timestamp();
+    });
+
+    for (auto &events : batches) {
+        if (events.size() == 1 && (!batch_.maxFrames || events.front()->group)) {
+            emit(env, callback, std::move(events.front()));
+        } else {
+            emitBatch(env, callback, std::move(events));
+        }
+    }
+}
+
+void NodeCamera::emitBatch(Napi::Env env, Napi::Function callback, std::vector<std::unique_ptr<Event>> frames) {
+    const int64_t start = nowNs();
+    constexpr size_t fields = lcam::FrameMetadata::FieldCount;
+    const size_t count = frames.size();
+    const auto type = frames.front()->streamType;
+    const auto streamId = frames.front()->frame.streamId;
+
+    auto buffers = Napi::Array::New(env, count);
+    auto timestamps = Napi::BigUint64Array::New(env, count);
+    auto sequences = Napi::Uint32Array::New(env, count);
+    auto metadata = Napi::Float64Array::New(env, count * fields);
+
+    for (size_t i = 0; i < count; i++) {
+        const auto &frame = frames[i]->frame;
+        timestamps[i] = frame.timestamp;
+        sequences[i] = frame.sequence;
+        std::copy(frame.metadata.values.begin(), frame.metadata.values.end(), metadata.Data() + i * fields);
+
+        // Each Buffer keeps its own frame alive until GC
+        buffers.Set(i, wrapFrame(env, std::move(frames[i])));
+    }
+
+    auto obj = Napi::Object::New(env);
+    obj.Set("type", "batch");
+    obj.Set("stream", streamTypeName(type));
+    obj.Set("streamId", streamId);
+    obj.Set("data", buffers);
+    obj.Set("timestamps", timestamps);
+    obj.Set("sequences", sequences);
+    obj.Set("metadata", metadata);  // FieldCount values per frame, batches may be kept
+
+    dispatchNs_ += static_cast<uint64_t>(nowNs() - start);
+    dispatchedFrames_ += count;
+    callback.Call({obj});
+}
+
+void NodeCamera::emit(Napi::Env env, Napi::Function callback, std::unique_ptr<Event> event) {
+    if (event->group) {
+        const auto &group = *event->group;
+        auto frames = Napi::Array::New(env, group.frames.size());
+        for (size_t i = 0; i < group.frames.size(); i++) {
+            const auto &[type, frame] = group.frames[i];
+            auto frameObj = frameToObject(env, frame, transfers(type));
+            frameObj.Set("stream", streamTypeName(type));
+            frames.Set(i, frameObj);
         }
+
+        auto obj = Napi::Object::New(env);
+        obj.Set("type", "group");
+        obj.Set("sequence", group.sequence);
+        obj.Set("timestamp", Napi::BigInt::New(env, group.timestamp));
+        obj.Set("complete", group.complete);
+        obj.Set("metadata", metadataView(env, group.metadata));
+        obj.Set("frames", frames);
+        callback.Call({obj});
+        return;
+    }
+
+    // Frames go out as positional arguments, so no property keys are
+    // created and no objects change shape here; lib/camera.ts builds the
+    // event with one fixed shape
+    const int64_t start = nowNs();
+    const auto &frame = event->frame;
+    auto type = Napi::Number::New(env, static_cast<uint32_t>(event->streamType));
+    auto timestamp = Napi::BigInt::New(env, frame.timestamp);
+    auto sequence = Napi::Number::New(env, frame.sequence);
+    auto streamId = Napi::Number::New(env, frame.streamId);
+    auto metadata = metadataView(env, frame.metadata);
+    auto data = wrapFrame(env, std::move(event));
+
+    dispatchNs_ += static_cast<uint64_t>(nowNs() - start);
+    dispatchedFrames_++;
+    callback.Call({type, data, timestamp, sequence, streamId, metadata});
+}
+
+Napi::Buffer<uint8_t> NodeCamera::wrapFrame(Napi::Env env, std::unique_ptr<Event> event) const {
+    const auto &data = event->frame.data;
+
+    // External memory cannot be transferred, a copy V8 owns can; the frame
+    // is released when this returns
+    if (transfers(event->streamType)) return Napi::Buffer<uint8_t>::Copy(env, data.data(), data.size());
+
+    auto *hint = event.release();
+    return Napi::Buffer<uint8_t>::New(
+        env,
+        const_cast<uint8_t *>(data.data()),
+        data.size(),
+        [](Napi::Env env, uint8_t *finalizeData, Event *hint) {
+            delete hint;
+        },
+        hint
     );
+}
+
+bool NodeCamera::offer(lcam::StreamType type, const lcam::Frame &frame) {
+    if (!pulling_.load(std::memory_order_relaxed)) return false;
+
+    {
+        std::lock_guard lock(mailboxMutex_);
+        if (!pulls_.contains(frame.streamId)) return false;
+    }
+
+    // The held frame outlives this callback, copied outside the lock
+    auto event = std::make_unique<Event>();
+    event->streamType = type;
+    event->frame = ownedFrame(frame);
+
+    std::unique_ptr<Event> replaced;  // Released after the lock
+    std::lock_guard lock(mailboxMutex_);
+
+    auto it = pulls_.find(frame.streamId);
+    if (it == pulls_.end()) return true;
+    auto &slot = it->second;
 
-    return Napi::Boolean::New(env, success);
+    if (slot.latest) slot.replaced++;
+    replaced = std::exchange(slot.latest, std::move(event));
+
+    // Nobody asked, so no N-API work at all
+    if (!slot.waiting || pullScheduled_) return true;
+
+    pullScheduled_ = pullTsfn_.NonBlockingCall(
+        [this, alive = alive_](Napi::Env env, Napi::Function) {
+            if (*alive) resolvePulls(env);
+        }) == napi_ok;
+    return true;
+}
+
+void NodeCamera::resolvePulls(Napi::Env env) {
+    std::vector<std::pair<uint32_t, std::unique_ptr<Event>>> ready;
+    {
+        std::lock_guard lock(mailboxMutex_);
+        pullScheduled_ = false;
+
+        for (auto &[id, slot] : pulls_) {
+            if (!slot.waiting || !slot.latest) continue;
+            slot.waiting = 0;
+            slot.taken++;
+            ready.emplace_back(id, std::move(slot.latest));
+        }
+    }
+
+    // Callers waiting on the same stream share one frame
+    for (auto &[id, event] : ready) {
+        const auto waiters = std::exchange(pullWaiters_[id], {});
+        const auto frame = frameToObject(env, event->frame, transfers(event->streamType));
+        for (const auto &deferred : waiters) deferred.Resolve(frame);
+    }
+}
+
+Napi::Value NodeCamera::NextFrame(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkInitialized(env)) return env.Undefined();
+
+    if (!info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Expected stream id").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    const uint32_t streamId = info[0].As<Napi::Number>().Uint32Value();
+    auto deferred = Napi::Promise::Deferred::New(env);
+    std::unique_ptr<Event> ready;
+    {
+        std::lock_guard lock(mailboxMutex_);
+        auto it = pulls_.find(streamId);
+        if (it == pulls_.end()) {
+            deferred.Reject(Napi::Error::New(env, "Stream " + std::to_string(streamId) + " is not in pull mode").Value());
+            return deferred.Promise();
+        }
+
+        if (it->second.latest) {
+            it->second.taken++;
+            ready = std::move(it->second.latest);
+        } else {
+            if (!pullTsfnActive_) {
+                // No JS function, resolvePulls() does all the work
+                pullTsfn_ = Napi::ThreadSafeFunction::New(env, Napi::Function(), "camera_pull", 0, 1);
+                pullTsfnActive_ = true;
+            }
+            it->second.waiting++;
+        }
+    }
+
+    if (ready) {
+        deferred.Resolve(frameToObject(env, ready->frame, transfers(ready->streamType)));
+        return deferred.Promise();
+    }
+
+    // Resolved on the JS thread, so it is queued before resolvePulls() runs
+    pullWaiters_[streamId].push_back(deferred);
+
+    // On-demand JPEG streams encode their next frame for it. The streams
+    // may be rebuilt while an async operation runs, so it asks afterwards.
+    if (!busy_) camera_->requestFrame(streamId);
+    return deferred.Promise();
 }
 
 Napi::Value NodeCamera::Stop(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+
     camera_->stop();
-    return info.Env().Undefined();
+    cancelPulls(env);
+    return env.Undefined();
+}
+
+void NodeCamera::cancelPulls(Napi::Env env) {
+    // Pending nextFrame() calls would wait for the next start()
+    {
+        std::lock_guard lock(mailboxMutex_);
+        for (auto &[id, slot] : pulls_) slot.waiting = 0;
+    }
+    for (auto &[id, waiters] : std::exchange(pullWaiters_, {})) {
+        for (const auto &deferred : waiters) deferred.Reject(Napi::Error::New(env, "Camera stopped").Value());
+    }
+}
+
+Napi::Value NodeCamera::CaptureStill(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+
+    // Optional sensor timestamp to match, most recent frame otherwise
+    uint64_t at = 0;
+    if (info[0].IsBigInt()) {
+        bool lossless;
+        at = info[0].As<Napi::BigInt>().Uint64Value(&lossless);
+    }
+
+    return Napi::Boolean::New(env, camera_->captureStill(at));
+}
+
+Napi::Value NodeCamera::Pause(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+    return Napi::Boolean::New(env, camera_->pause());
+}
+
+Napi::Value NodeCamera::Resume(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+    return Napi::Boolean::New(env, camera_->resume());
+}
+
+Napi::Value NodeCamera::Reconfigure(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    if (!info[0].IsObject()) {
+        Napi::TypeError::New(env, "Configuration object expected").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    if (!checkIdle(env)) return env.Undefined();
+
+    const auto cameraConfig = parseConfig(info[0].As<Napi::Object>());
+    parseDelivery(info[0].As<Napi::Object>());
+    return Napi::Boolean::New(env, camera_->reconfigure(cameraConfig));
 }
 
 Napi::Value NodeCamera::SetControls(const Napi::CallbackInfo &info) {
     Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
 
     if (!info[0].IsObject()) {
         Napi::TypeError::New(env, "Controls object expected").ThrowAsJavaScriptException();
@@ -250,12 +917,83 @@ Napi::Value NodeCamera::SetControls(const Napi::CallbackInfo &info) {
     return Napi::Boolean::New(env, camera_->setControls(controls));
 }
 
+Napi::Value NodeCamera::ScheduleControls(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+
+    if (!info[0].IsObject()) {
+        Napi::TypeError::New(env, "Controls object expected").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto controls = parseControls(info[0].As<Napi::Object>());
+    const uint32_t framesAhead = info[1].IsNumber() ? info[1].As<Napi::Number>().Uint32Value() : 0;
+
+    return Napi::Number::New(env, camera_->scheduleControls(controls, framesAhead));
+}
+
+Napi::Value NodeCamera::Bracket(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+
+    if (!info[0].IsArray()) {
+        Napi::TypeError::New(env, "Array of controls objects expected").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto array = info[0].As<Napi::Array>();
+    std::vector<lcam::Controls> sets;
+    for (uint32_t i = 0; i < array.Length(); i++) {
+        Napi::Value entry = array[i];
+        if (!entry.IsObject()) {
+            Napi::TypeError::New(env, "Array of controls objects expected").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        sets.push_back(parseControls(entry.As<Napi::Object>()));
+    }
+
+    const auto tags = camera_->setBracket(sets);
+    auto result = Napi::Array::New(env, tags.size());
+    for (size_t i = 0; i < tags.size(); i++) {
+        result.Set(i, tags[i]);
+    }
+
+    return result;
+}
+
+Napi::Value NodeCamera::SetCrop(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+
+    if (!info[0].IsObject()) {
+        Napi::TypeError::New(env, "Crop region object expected").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    // Missing edges default to the full field of view
+    auto obj = info[0].As<Napi::Object>();
+    lcam::CropRegion region;
+    auto read = [&obj](const char* key, double& target) {
+        if (obj.Has(key)) target = obj.Get(key).As<Napi::Number>().DoubleValue();
+    };
+    read("x", region.x);
+    read("y", region.y);
+    read("width", region.width);
+    read("height", region.height);
+
+    const uint32_t transitionFrames = info[1].IsNumber() ? info[1].As<Napi::Number>().Uint32Value() : 0;
+    return Napi::Boolean::New(env, camera_->setCrop(region, transitionFrames));
+}
+
 Napi::Value NodeCamera::GetControls(const Napi::CallbackInfo &info) {
-    return controlsToObject(info.Env(), camera_->getControls());
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+    return controlsToObject(env, camera_->getControls());
 }
 
 Napi::Value NodeCamera::GetCapabilities(const Napi::CallbackInfo &info) {
     Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
     auto caps = camera_->getCapabilities();
     auto result = Napi::Object::New(env);
 
@@ -284,9 +1022,420 @@ Napi::Value NodeCamera::GetCapabilities(const Napi::CallbackInfo &info) {
     result.Set("afModes", createArray(caps.afModes));
     result.Set("awbModes", createArray(caps.awbModes));
 
+    // Every control the camera reports, keyed by libcamera name
+    auto controls = Napi::Object::New(env);
+    for (const auto &entry : caps.controls) {
+        auto control = Napi::Object::New(env);
+        control.Set("id", entry.id);
+        control.Set("type", controlTypeName(entry.type));
+        control.Set("array", entry.isArray);
+        if (entry.size) control.Set("size", static_cast<double>(entry.size));
+        if (!std::isnan(entry.min)) control.Set("min", entry.min);
+        if (!std::isnan(entry.max)) control.Set("max", entry.max);
+        if (!std::isnan(entry.def)) control.Set("default", entry.def);
+
+        if (!entry.enumerators.empty()) {
+            auto values = Napi::Object::New(env);
+            for (const auto &[value, name] : entry.enumerators) {
+                values.Set(name, value);
+            }
+            control.Set("values", values);
+        }
+
+        controls.Set(entry.name, control);
+    }
+    result.Set("controls", controls);
+
+    return result;
+}
+
+Napi::Value NodeCamera::FrameLayout(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+
+    const uint32_t streamId = info[0].IsNumber() ? info[0].As<Napi::Number>().Uint32Value() : 0;
+    const auto layout = camera_->getStreamLayout(streamId);
+    if (!layout) return env.Undefined();
+
+    auto result = Napi::Object::New(env);
+    result.Set("stream", streamTypeName(layout->type));
+    result.Set("width", layout->width);
+    result.Set("height", layout->height);
+    result.Set("stride", layout->stride);
+    result.Set("frameBytes", static_cast<double>(layout->frameBytes));
     return result;
 }
 
+Napi::Value NodeCamera::AttachRing(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+
+    if (!info[0].IsTypedArray() || !info[1].IsNumber() || !info[2].IsNumber() || !info[3].IsFunction()) {
+        Napi::TypeError::New(env, "Expected shared memory view, slot count, stream id and callback")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto memory = info[0].As<Napi::Uint8Array>();
+    const uint32_t slots = info[1].As<Napi::Number>().Uint32Value();
+    const uint32_t streamId = info[2].As<Napi::Number>().Uint32Value();
+
+    const auto layout = camera_->getStreamLayout(streamId);
+    if (!layout || layout->type != lcam::StreamType::RGB) {
+        Napi::TypeError::New(env, "Frame rings need an RGB stream").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    if (!slots || memory.ByteLength() < lcam::FrameRing::requiredBytes(slots, layout->frameBytes)) {
+        Napi::RangeError::New(env, "Shared memory is too small for the ring").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    detachRing(streamId);
+
+    auto *ring = new Ring();
+    ring->ring = std::make_unique<lcam::FrameRing>(memory.Data(), slots, layout->frameBytes);
+    ring->memory = Napi::Persistent(memory);
+    ring->tsfn = Napi::ThreadSafeFunction::New(
+        env,
+        info[3].As<Napi::Function>(),
+        "camera_ring",
+        0,
+        1,
+        ring,
+        [](Napi::Env env, Ring *ring) { delete ring; }
+    );
+
+    // Runs on the delivering thread, the copy is the only per-frame work
+    ring->listenerId = camera_->addFrameListener([ring, streamId](lcam::StreamType type, const lcam::Frame &frame) {
+        if (type != lcam::StreamType::RGB || frame.streamId != streamId) return;
+        const uint32_t slot = ring->ring->write(frame);
+
+        // Signals are coalesced, a lagging consumer finds the newest slot
+        // in the ring header
+        if (ring->signalPending.exchange(true, std::memory_order_acq_rel)) return;
+
+        auto *data = reinterpret_cast<void *>(static_cast<uintptr_t>(slot));
+        const auto status = ring->tsfn.NonBlockingCall(data, [ring](Napi::Env env, Napi::Function cb, void *data) {
+            ring->signalPending.store(false, std::memory_order_release);
+            cb.Call({Napi::Number::New(env, static_cast<double>(reinterpret_cast<uintptr_t>(data)))});
+        });
+        if (status != napi_ok) ring->signalPending.store(false, std::memory_order_release);
+    });
+
+    rings_[streamId] = ring;
+    return env.Undefined();
+}
+
+Napi::Value NodeCamera::DetachRing(const Napi::CallbackInfo &info) {
+    if (info[0].IsNumber()) detachRing(info[0].As<Napi::Number>().Uint32Value());
+    return info.Env().Undefined();
+}
+
+void NodeCamera::detachRing(uint32_t streamId) {
+    auto it = rings_.find(streamId);
+    if (it == rings_.end()) return;
+
+    // Waits for a write in progress, the ring gets no frames afterwards
+    camera_->removeFrameListener(it->second->listenerId);
+    it->second->tsfn.Release();
+    rings_.erase(it);
+}
+
+Napi::Value NodeCamera::GetStats(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (!checkIdle(env)) return env.Undefined();
+    const auto stats = camera_->getStats();
+    auto result = Napi::Object::New(env);
+
+    result.Set("cameraId", stats.cameraId);
+    result.Set("requestsCompleted", static_cast<double>(stats.requestsCompleted));
+    result.Set("achievedFps", stats.achievedFps);
+    result.Set("rgbFramesDelivered", static_cast<double>(stats.rgbFramesDelivered));
+    result.Set("jpegFramesEncoded", static_cast<double>(stats.jpegFramesEncoded));
+    result.Set("jpegEncodeErrors", static_cast<double>(stats.jpegEncodeErrors));
+    result.Set("jpegFramesSkipped", static_cast<double>(stats.jpegFramesSkipped));
+    result.Set("jpegFramesDropped", static_cast<double>(stats.jpegFramesDropped));
+    result.Set("jpegQueueDepth", static_cast<double>(stats.jpegQueueDepth));
+    result.Set("reconfigures", static_cast<double>(stats.reconfigures));
+    result.Set("lastStartMs", stats.lastStartMs);
+    result.Set("lastBlackoutMs", stats.lastBlackoutMs);
+    result.Set("paused", stats.paused);
+    result.Set("resumes", static_cast<double>(stats.resumes));
+    result.Set("lastResumeMs", stats.lastResumeMs);
+    result.Set("stillsCaptured", static_cast<double>(stats.stillsCaptured));
+    result.Set("stillsDropped", static_cast<double>(stats.stillsDropped));
+    result.Set("stillQueueDepth", static_cast<double>(stats.stillQueueDepth));
+    result.Set("controlApplies", static_cast<double>(stats.controlApplies));
+    result.Set("controlsWritten", static_cast<double>(stats.controlsWritten));
+    result.Set("controlApplyAvgUs", stats.controlApplyAvgUs);
+    result.Set("groupsDelivered", static_cast<double>(stats.groupsDelivered));
+    result.Set("groupsIncomplete", static_cast<double>(stats.groupsIncomplete));
+    result.Set("requestsInFlight", static_cast<double>(stats.requestsInFlight));
+    result.Set("stalls", static_cast<double>(stats.stalls));
+    result.Set("recoveries", static_cast<double>(stats.recoveries));
+    result.Set("lastRecoveryMs", stats.lastRecoveryMs);
+    result.Set("completionCallbacks", static_cast<double>(stats.completionCallbacks));
+    result.Set("completionCallbackAvgUs", stats.completionCallbackAvgUs);
+    result.Set("completionCallbackMaxUs", stats.completionCallbackMaxUs);
+
+    // Delivery queues between the capture threads and JavaScript
+    auto delivery = Napi::Array::New(env);
+    uint64_t dropped = 0;
+    {
+        std::lock_guard lock(mailboxMutex_);
+        for (const auto &[key, mailbox] : mailboxes_) {
+            auto entry = Napi::Object::New(env);
+            entry.Set("stream", key == kGroupMailbox ? "group" : streamTypeName(mailbox.type));
+            entry.Set("streamId", key == kGroupMailbox ? -1.0 : static_cast<double>(key));
+            entry.Set("queued", static_cast<double>(mailbox.queue.size()));
+            entry.Set("capacity", static_cast<double>(mailbox.queue.capacity()));
+            entry.Set("delivered", static_cast<double>(mailbox.queue.popped()));
+            entry.Set("dropped", static_cast<double>(mailbox.queue.dropped()));
+            delivery.Set(delivery.Length(), entry);
+            dropped += mailbox.queue.dropped();
+        }
+
+        // Pull-mode streams hold one frame
+        for (const auto &[id, slot] : pulls_) {
+            auto entry = Napi::Object::New(env);
+            entry.Set("stream", streamTypeName(slot.type));
+            entry.Set("streamId", static_cast<double>(id));
+            entry.Set("queued", slot.latest ? 1.0 : 0.0);
+            entry.Set("capacity", 1.0);
+            entry.Set("delivered", static_cast<double>(slot.taken));
+            entry.Set("dropped", static_cast<double>(slot.replaced));
+            delivery.Set(delivery.Length(), entry);
+            dropped += slot.replaced;
+        }
+    }
+    result.Set("framesDropped", static_cast<double>(dropped));
+    result.Set("delivery", delivery);
+    result.Set("framesDispatched", static_cast<double>(dispatchedFrames_));
+    result.Set("dispatchAvgNs", dispatchedFrames_ ? static_cast<double>(dispatchNs_) / dispatchedFrames_ : 0.0);
+
+    return result;
+}
+
+Napi::Value NodeCamera::IsRunning(const Napi::CallbackInfo &info) {
+    return Napi::Boolean::New(info.Env(), initialized_ && camera_->isRunning());
+}
+
+Napi::Value NodeCamera::ListCameras(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    const auto cameras = lcam::SharedCameraManager::listCameras();
+    auto result = Napi::Array::New(env, cameras.size());
+
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        const auto &camera = cameras[i];
+        auto obj = Napi::Object::New(env);
+        obj.Set("id", camera.id);
+        obj.Set("model", camera.model);
+        obj.Set("location", camera.location);
+        obj.Set("pixelArrayWidth", camera.pixelArrayWidth);
+        obj.Set("pixelArrayHeight", camera.pixelArrayHeight);
+        result[i] = obj;
+    }
+
+    return result;
+}
+
+lcam::CameraConfig NodeCamera::parseConfig(const Napi::Object &config) {
+    lcam::CameraConfig cameraConfig;
+
+    // Parse camera selection
+    if (config.Has("cameraId")) {
+        cameraConfig.cameraId = config.Get("cameraId").As<Napi::String>().Utf8Value();
+    }
+
+    // Parse optional RAW stream configuration
+    if (config.Has("rawStream")) {
+        auto rawStreamObj = config.Get("rawStream").As<Napi::Object>();
+        lcam::StreamConfig rawStream;
+        rawStream.type = lcam::StreamType::RAW;
+
+        if (rawStreamObj.Has("width")) {
+            rawStream.width = rawStreamObj.Get("width").As<Napi::Number>().Uint32Value();
+        } else {
+            rawStream.width = 2304;  // Default sensor resolution
+        }
+
+        if (rawStreamObj.Has("height")) {
+            rawStream.height = rawStreamObj.Get("height").As<Napi::Number>().Uint32Value();
+        } else {
+            rawStream.height = 1296;  // Default sensor resolution
+        }
+
+        cameraConfig.rawStream = rawStream;
+    }
+
+    // Parse stream configuration
+    if (config.Has("streams")) {
+        const auto streams = config.Get("streams").As<Napi::Array>();
+
+        for (uint32_t i = 0; i < streams.Length(); ++i) {
+            auto streamObj = streams.Get(i).As<Napi::Object>();
+            auto typeStr = streamObj.Get("type").As<Napi::String>().Utf8Value();
+
+            lcam::StreamConfig sc;
+
+            if (typeStr == "jpeg") {
+                sc.type = lcam::StreamType::JPEG;
+            } else if (typeStr == "rgb") {
+                sc.type = lcam::StreamType::RGB;
+            } else if (typeStr == "still") {
+                sc.type = lcam::StreamType::STILL;
+            } else {
+                continue;  // Skip unknown types
+            }
+
+            if (streamObj.Has("width")) sc.width = streamObj.Get("width").As<Napi::Number>().Uint32Value();
+            if (streamObj.Has("height")) sc.height = streamObj.Get("height").As<Napi::Number>().Uint32Value();
+            if (streamObj.Has("quality")) sc.quality = streamObj.Get("quality").As<Napi::Number>().Int32Value();
+
+            // Pulled JPEG frames are only encoded when asked for
+            const bool pull = streamObj.Has("pull") ? streamObj.Get("pull").ToBoolean().Value()
+                                                    : config.Has("pull") && config.Get("pull").ToBoolean().Value();
+            sc.onDemand = pull && sc.type == lcam::StreamType::JPEG;
+
+            cameraConfig.streams.push_back(sc);
+        }
+    }
+
+    // Parse initial control values
+    if (config.Has("controls")) {
+        cameraConfig.initialControls = parseControls(config.Get("controls").As<Napi::Object>());
+    }
+
+    // Parse JPEG encoder queue size
+    if (config.Has("jpegEncoderQueueSize")) {
+        cameraConfig.jpegEncoderQueueSize = config.Get("jpegEncoderQueueSize").As<Napi::Number>().Uint32Value();
+    }
+
+    // Parse zero-shutter-lag ring depth
+    if (config.Has("zslDepth")) {
+        cameraConfig.zslDepth = config.Get("zslDepth").As<Napi::Number>().Uint32Value();
+    }
+
+    // Parse stall watchdog settings
+    if (config.Has("stallTimeoutMs")) {
+        cameraConfig.stallTimeoutMs = config.Get("stallTimeoutMs").As<Napi::Number>().Uint32Value();
+    }
+    if (config.Has("autoRecover")) {
+        cameraConfig.autoRecover = config.Get("autoRecover").As<Napi::Boolean>().Value();
+    }
+    if (config.Has("writeAllControls")) {
+        cameraConfig.writeAllControls = config.Get("writeAllControls").As<Napi::Boolean>().Value();
+    }
+
+    // Parse grouped per-request delivery
+    if (config.Has("groupedDelivery")) {
+        cameraConfig.groupedDelivery = config.Get("groupedDelivery").As<Napi::Boolean>().Value();
+    }
+    if (config.Has("groupDeadlineMs")) {
+        cameraConfig.groupDeadlineMs = config.Get("groupDeadlineMs").As<Napi::Number>().Uint32Value();
+    }
+
+    // Parse per-buffer early delivery mode
+    if (config.Has("earlyDelivery")) {
+        cameraConfig.earlyDelivery = config.Get("earlyDelivery").As<Napi::Boolean>().Value();
+    }
+
+    return cameraConfig;
+}
+
+void NodeCamera::parseDelivery(const Napi::Object &config) {
+    auto parseLimits = [](const Napi::Object &obj, DeliveryLimits &limits) {
+        if (obj.Has("queueSize")) limits.queueSize = obj.Get("queueSize").As<Napi::Number>().Uint32Value();
+        if (obj.Has("overflow")) {
+            limits.overflow = obj.Get("overflow").As<Napi::String>().Utf8Value() == "dropNewest"
+                                  ? lcam::OverflowPolicy::DropNewest
+                                  : lcam::OverflowPolicy::DropOldest;
+        }
+    };
+
+    DeliveryLimits defaults;
+    if (config.Has("delivery") && config.Get("delivery").IsObject()) {
+        parseLimits(config.Get("delivery").As<Napi::Object>(), defaults);
+    }
+
+    const bool pullAll = config.Has("pull") && config.Get("pull").ToBoolean().Value();
+    transferable_ = config.Has("transferable") && config.Get("transferable").ToBoolean().Value();
+
+    // Stream ids count the streams parseConfig() accepts
+    std::map<uint32_t, DeliveryLimits> limits;
+    std::map<uint32_t, lcam::StreamType> pulled;
+    if (config.Has("streams") && config.Get("streams").IsArray()) {
+        const auto streams = config.Get("streams").As<Napi::Array>();
+        uint32_t id = 0;
+
+        for (uint32_t i = 0; i < streams.Length(); ++i) {
+            auto streamObj = streams.Get(i).As<Napi::Object>();
+            const auto type = streamObj.Get("type").As<Napi::String>().Utf8Value();
+            if (type != "jpeg" && type != "rgb" && type != "still") continue;
+
+            if (streamObj.Has("queueSize") || streamObj.Has("overflow")) {
+                auto &stream = limits[id] = defaults;
+                parseLimits(streamObj, stream);
+            }
+            if (streamObj.Has("pull") ? streamObj.Get("pull").ToBoolean().Value() : pullAll) {
+                pulled[id] = type == "jpeg" ? lcam::StreamType::JPEG
+                           : type == "rgb" ? lcam::StreamType::RGB : lcam::StreamType::STILL;
+            }
+            id++;
+        }
+    }
+
+    // Nothing will resolve nextFrame() calls of streams that stopped pulling
+    for (auto it = pullWaiters_.begin(); it != pullWaiters_.end();) {
+        if (pulled.count(it->first)) {
+            ++it;
+            continue;
+        }
+        for (const auto &deferred : it->second) {
+            deferred.Reject(Napi::Error::New(config.Env(), "Stream " + std::to_string(it->first) + " is no longer in pull mode").Value());
+        }
+        it = pullWaiters_.erase(it);
+    }
+
+    BatchLimits batch;
+    if (config.Has("batch") && config.Get("batch").IsObject()) {
+        auto obj = config.Get("batch").As<Napi::Object>();
+        batch.maxFrames = obj.Has("maxFrames") ? obj.Get("maxFrames").As<Napi::Number>().Uint32Value() : 8;
+        if (obj.Has("maxDelayMs")) batch.maxDelayMs = obj.Get("maxDelayMs").As<Napi::Number>().Uint32Value();
+
+        // A queue smaller than a batch would drop frames of every batch
+        defaults.queueSize = std::max<size_t>(defaults.queueSize, batch.maxFrames);
+        for (auto &[id, stream] : limits) {
+            stream.queueSize = std::max<size_t>(stream.queueSize, batch.maxFrames);
+        }
+    }
+
+    {
+        std::lock_guard lock(mailboxMutex_);
+        deliveryDefaults_ = defaults;
+        deliveryLimits_ = std::move(limits);
+        batch_ = batch;
+
+        std::erase_if(pulls_, [&](const auto &entry) { return !pulled.count(entry.first); });
+        for (const auto &[id, type] : pulled) pulls_[id].type = type;
+        pulling_.store(!pulled.empty(), std::memory_order_relaxed);
+
+        for (auto &[key, mailbox] : mailboxes_) {
+            auto it = deliveryLimits_.find(key);
+            const auto &[queueSize, overflow] = it != deliveryLimits_.end() ? it->second : deliveryDefaults_;
+            mailbox.queue.configure(queueSize, overflow);
+        }
+
+        if (flusherRunning_ || !batch.maxFrames) {
+            batchCv_.notify_one();
+            return;
+        }
+        flusherRunning_ = true;
+    }
+
+    batchFlusher_ = std::thread(&NodeCamera::batchFlushThread, this);
+}
+
 lcam::Controls NodeCamera::parseControls(const Napi::Object &obj) {
     lcam::Controls controls;
 
@@ -326,8 +1475,55 @@ lcam::Controls NodeCamera::parseControls(const Napi::Object &obj) {
     getFloat("saturation", controls.saturation);
     getFloat("sharpness", controls.sharpness);
     getInt("targetFps", controls.targetFps);
+    getFloat("minFps", controls.minFps);
+    getFloat("maxFps", controls.maxFps);
+    if (obj.Has("maxThroughput")) controls.maxThroughput = obj.Get("maxThroughput").ToBoolean().Value();
     getInt("jpegQuality", controls.jpegQuality);
 
+    // Any other libcamera control, keyed by name or numeric id
+    if (obj.Has("extra") && obj.Get("extra").IsObject()) {
+        auto extra = obj.Get("extra").As<Napi::Object>();
+        auto keys = extra.GetPropertyNames();
+
+        for (uint32_t i = 0; i < keys.Length(); i++) {
+            const std::string key = keys.Get(i).ToString().Utf8Value();
+            Napi::Value value = extra.Get(key);
+
+            lcam::ControlSetting setting;
+            if (!key.empty() && std::all_of(key.begin(), key.end(), ::isdigit)) {
+                setting.id = static_cast<uint32_t>(std::stoul(key));
+            } else {
+                setting.name = key;
+            }
+
+            if (value.IsBoolean()) {
+                setting.values = {value.As<Napi::Boolean>().Value() ? 1.0 : 0.0};
+            } else if (value.IsNumber()) {
+                setting.values = {value.As<Napi::Number>().DoubleValue()};
+            } else if (value.IsArray()) {
+                auto array = value.As<Napi::Array>();
+                for (uint32_t j = 0; j < array.Length(); j++) {
+                    setting.values.push_back(array.Get(j).As<Napi::Number>().DoubleValue());
+                }
+            } else if (value.IsObject()) {
+                // Rectangles { x, y, width, height } and sizes { width, height }
+                auto shape = value.As<Napi::Object>();
+                if (shape.Has("x")) {
+                    setting.values = {
+                        shape.Get("x").As<Napi::Number>().DoubleValue(),
+                        shape.Get("y").As<Napi::Number>().DoubleValue()
+                    };
+                }
+                setting.values.push_back(shape.Get("width").As<Napi::Number>().DoubleValue());
+                setting.values.push_back(shape.Get("height").As<Napi::Number>().DoubleValue());
+            } else {
+                continue;
+            }
+
+            controls.extra.push_back(std::move(setting));
+        }
+    }
+
     return controls;
 }
 
@@ -359,8 +1555,28 @@ Napi::Object NodeCamera::controlsToObject(Napi::Env env, const lcam::Controls &c
     setIf("saturation", controls.saturation);
     setIf("sharpness", controls.sharpness);
     setIf("targetFps", controls.targetFps);
+    setIf("minFps", controls.minFps);
+    setIf("maxFps", controls.maxFps);
+    setIf("maxThroughput", controls.maxThroughput);
     setIf("jpegQuality", controls.jpegQuality);
 
+    if (!controls.extra.empty()) {
+        auto extra = Napi::Object::New(env);
+        for (const auto &setting : controls.extra) {
+            if (setting.values.size() == 1) {
+                extra.Set(setting.name, setting.values[0]);
+                continue;
+            }
+
+            auto values = Napi::Array::New(env, setting.values.size());
+            for (size_t i = 0; i < setting.values.size(); i++) {
+                values.Set(i, setting.values[i]);
+            }
+            extra.Set(setting.name, values);
+        }
+        obj.Set("extra", extra);
+    }
+
     return obj;
 }
 
@@ -0,0 +1,177 @@
+#include "sync_binding.hpp"
+#include "node_binding.hpp"
+
+void NodeFrameSync::Init(Napi::Env env, Napi::Object exports) {
+    Napi::Function func = DefineClass(env, "FrameSync", {
+        InstanceMethod("push", &NodeFrameSync::Push),
+        InstanceMethod("getStats", &NodeFrameSync::GetStats),
+        InstanceMethod("close", &NodeFrameSync::Close),
+    });
+
+    exports.Set("FrameSync", func);
+}
+
+NodeFrameSync::NodeFrameSync(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<NodeFrameSync>(info) {
+    Napi::Env env = info.Env();
+
+    // (left: Camera | null, right: Camera | null, options, callback)
+    if (!info[2].IsObject() || !info[3].IsFunction()) {
+        Napi::TypeError::New(env, "Expected cameras, options object and callback").ThrowAsJavaScriptException();
+        return;
+    }
+
+    for (size_t side = 0; side < 2; ++side) {
+        if (!info[side].IsNull() && !info[side].IsUndefined() && !NodeCamera::IsInstance(info[side])) {
+            Napi::TypeError::New(env, "Camera instance or null expected").ThrowAsJavaScriptException();
+            return;
+        }
+    }
+
+    const auto options = info[2].As<Napi::Object>();
+
+    // Stream to pair, defaults to the first RGB stream
+    lcam::StreamType streamType = lcam::StreamType::RGB;
+    if (options.Has("stream")) {
+        streamType = options.Get("stream").As<Napi::String>().Utf8Value() == "jpeg"
+                         ? lcam::StreamType::JPEG
+                         : lcam::StreamType::RGB;
+    }
+
+    std::optional<uint32_t> streamId;
+    if (options.Has("streamId")) {
+        streamId = options.Get("streamId").As<Napi::Number>().Uint32Value();
+    }
+
+    uint64_t toleranceNs = 5'000'000;  // 5ms
+    if (options.Has("toleranceUs")) {
+        const int64_t toleranceUs = options.Get("toleranceUs").As<Napi::Number>().Int64Value();
+        if (toleranceUs <= 0) {
+            Napi::TypeError::New(env, "toleranceUs must be a positive number").ThrowAsJavaScriptException();
+            return;
+        }
+        toleranceNs = static_cast<uint64_t>(toleranceUs) * 1000;
+    }
+
+    size_t maxPending = 4;
+    if (options.Has("maxPending")) {
+        maxPending = options.Get("maxPending").As<Napi::Number>().Uint32Value();
+    }
+
+    tsfn_ = Napi::ThreadSafeFunction::New(
+        env,
+        info[3].As<Napi::Function>(),
+        "frame_sync_events",
+        kPairQueueSize,
+        1
+    );
+
+    sync_ = std::make_unique<lcam::FrameSynchronizer>(
+        toleranceNs,
+        maxPending,
+        [tsfn = tsfn_, dropped = pairsDropped_](const lcam::FramePair &pair) mutable {
+            auto *data = new lcam::FramePair(pair);
+
+            // Never blocks: push() may pair on the JS thread itself, which
+            // would wait forever for a queue only it can drain
+            const auto status = tsfn.NonBlockingCall(data, [](Napi::Env env, Napi::Function cb, lcam::FramePair *data) {
+                auto event = Napi::Object::New(env);
+                event.Set("type", "pair");
+                event.Set("left", NodeCamera::frameToObject(env, data->left));
+                event.Set("right", NodeCamera::frameToObject(env, data->right));
+                event.Set("skew", static_cast<double>(data->skew));
+                delete data;  // Buffers hold their own references to the frames
+                cb.Call({event});
+            });
+            if (status != napi_ok) {
+                delete data;
+                dropped->fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    );
+    open_ = true;
+
+    // Feed the synchronizer straight from the cameras' delivery threads
+    for (size_t side = 0; side < 2; ++side) {
+        if (!NodeCamera::IsInstance(info[side])) continue;
+
+        auto cameraObj = info[side].As<Napi::Object>();
+        cameras_[side] = NodeCamera::Unwrap(cameraObj)->manager();
+        cameraRefs_[side] = Napi::Persistent(cameraObj);
+
+        auto *sync = sync_.get();
+        const auto syncSide = static_cast<lcam::FrameSynchronizer::Side>(side);
+        listenerIds_[side] = cameras_[side]->addFrameListener(
+            [sync, syncSide, streamType, streamId](lcam::StreamType type, const lcam::Frame &frame) {
+                if (type != streamType) return;
+                if (streamId && frame.streamId != *streamId) return;
+                sync->push(syncSide, frame);
+            }
+        );
+    }
+}
+
+NodeFrameSync::~NodeFrameSync() {
+    close();
+}
+
+void NodeFrameSync::close() {
+    if (!open_) return;
+    open_ = false;
+
+    for (size_t side = 0; side < 2; ++side) {
+        if (!cameras_[side]) continue;
+        cameras_[side]->removeFrameListener(listenerIds_[side]);
+        cameras_[side] = nullptr;
+        cameraRefs_[side].Reset();
+    }
+
+    tsfn_.Release();
+}
+
+Napi::Value NodeFrameSync::Push(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    // (side: 0 | 1, data: Buffer, timestamp: bigint, sequence?: number)
+    if (!info[0].IsNumber() || !info[1].IsBuffer() || !info[2].IsBigInt()) {
+        Napi::TypeError::New(env, "Expected side, buffer and bigint timestamp").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    if (!open_) return env.Undefined();
+
+    const auto side = info[0].As<Napi::Number>().Uint32Value() == 0
+                          ? lcam::FrameSynchronizer::LEFT
+                          : lcam::FrameSynchronizer::RIGHT;
+    const auto buffer = info[1].As<Napi::Buffer<uint8_t>>();
+
+    bool lossless;
+    lcam::Frame frame{
+        std::span<const uint8_t>(buffer.Data(), buffer.Length()),
+        info[2].As<Napi::BigInt>().Uint64Value(&lossless),
+        info[3].IsNumber() ? info[3].As<Napi::Number>().Uint32Value() : 0,
+        nullptr  // Copied by the synchronizer
+    };
+
+    sync_->push(side, frame);
+    return env.Undefined();
+}
+
+Napi::Value NodeFrameSync::GetStats(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    const auto stats = sync_->stats();
+    auto result = Napi::Object::New(env);
+
+    result.Set("pairs", static_cast<double>(stats.pairs));
+    result.Set("droppedLeft", static_cast<double>(stats.droppedLeft));
+    result.Set("droppedRight", static_cast<double>(stats.droppedRight));
+    result.Set("lastSkew", static_cast<double>(stats.lastSkew));
+    result.Set("pairsDropped", static_cast<double>(pairsDropped_->load(std::memory_order_relaxed)));
+
+    return result;
+}
+
+Napi::Value NodeFrameSync::Close(const Napi::CallbackInfo &info) {
+    close();
+    return info.Env().Undefined();
+}